@@ -1,5 +1,7 @@
 #include "olcPixelGameEngine.h"
 #include "olc_PGEX_SplashScreen.h"
+#include "olc_PGEX_AssetManager.h"
+#include "olc_PGEX_PerfOverlay.h"
 
 const int width = 512;
 const int height = 512;
@@ -11,6 +13,15 @@ std::string formatNum(float f)
     return rounded;
 }
 
+// Prefer the QOI version of a decal when it has been converted, it loads faster
+std::string decalFile(const std::string& name)
+{
+    std::string qoi = "data/decals/" + name + ".qoi";
+    if (std::ifstream(qoi).good())
+        return qoi;
+    return "data/decals/" + name + ".png";
+}
+
 class ProgressBar
 {
 public:
@@ -234,34 +245,31 @@ public:
 
     void draw(olc::PixelGameEngine* pge)
     {
-        olc::vi2d later;
-        olc::vi2d start = mCenter - ((mSize / 2) * mGridSize);
-
+        olc::ProfileZone zone("PlayGrid::draw");
         olc::vi2d hoverPos = { -1, -1 };
 
-        for (int x = 0; x < mGridSize.x; x++)
+        // Big boards are built a column per job, each recording into its own buffer, then
+        // submitted in column order so they draw exactly as they would have in one go
+        if (mGridSize.x * mGridSize.y >= mParallelTiles)
         {
-            int y = start.y;
-            for (int y = 0; y < mGridSize.y; y++)
+            mColumnBuffers.resize(mGridSize.x);
+            pge->GetJobSystem().ParallelFor(0, uint32_t(mGridSize.x), 1, [&](uint32_t first, uint32_t last)
             {
-                pge->DrawDecal(start, mTile);
-                if (x == mHoverIndex.x && y == mHoverIndex.y)
-                {
-                    hoverPos = start;
-                }
-                else
+                for (uint32_t x = first; x < last; x++)
                 {
-                    olc::Decal* d = mData[y * mGridSize.y + x];
-                    if (d)
-                    {
-                        pge->DrawDecal(start, d);
-                    }
-                    pge->DrawRectDecal(start, mSize, mBorder);
+                    mColumnBuffers[x].Begin();
+                    drawColumn(pge, int(x), hoverPos);
+                    mColumnBuffers[x].End();
                 }
-                start.y += mSize.y;
+            });
+            pge->SubmitDecalCommands(mColumnBuffers);
+        }
+        else
+        {
+            for (int x = 0; x < mGridSize.x; x++)
+            {
+                drawColumn(pge, x, hoverPos);
             }
-            start.x += mSize.x;
-            start.y = y;
         }
 
         if (hoverPos.x != -1 && hoverPos.y != -1)
@@ -275,6 +283,32 @@ public:
         }
     }
 
+    // Only the column holding the hovered tile writes hoverPos
+    void drawColumn(olc::PixelGameEngine* pge, int x, olc::vi2d& hoverPos)
+    {
+        olc::vi2d start = mCenter - ((mSize / 2) * mGridSize);
+        start.x += x * mSize.x;
+
+        for (int y = 0; y < mGridSize.y; y++)
+        {
+            pge->DrawDecal(start, mTile);
+            if (x == mHoverIndex.x && y == mHoverIndex.y)
+            {
+                hoverPos = start;
+            }
+            else
+            {
+                olc::Decal* d = mData[y * mGridSize.y + x];
+                if (d)
+                {
+                    pge->DrawDecal(start, d);
+                }
+                pge->DrawRectDecal(start, mSize, mBorder);
+            }
+            start.y += mSize.y;
+        }
+    }
+
     int getScrore()
     {
         int score = 0;
@@ -316,6 +350,10 @@ private:
     olc::Pixel mBorder = { 0,0,0,255 };
     olc::Pixel mHoverBorder = { 255,255,255,255 };
 
+    // Boards with fewer tiles than this are not worth handing out
+    const int mParallelTiles = 1024;
+    std::vector<olc::DecalCommandBuffer> mColumnBuffers;
+
 };
 
 struct LevelData
@@ -325,12 +363,15 @@ struct LevelData
     int mSizeX;
     int mSizeY;
     std::vector<olc::Decal*> mLevelGrid;
+    // Keeps the shapes used by this level resident
+    std::vector<std::shared_ptr<olc::Renderable>> mAssets;
 };
 
 class LevelLoader
 {
 public:
-    LevelLoader(std::string mainFile)
+    LevelLoader(std::string mainFile, olc::AssetManager& assets)
+        : mAssets(assets)
     {
         std::ifstream inFile(mainFile);
         if (inFile.is_open())
@@ -346,13 +387,17 @@ public:
         }
     }
 
-    void loadDecals()
+    olc::Decal* getShape(LevelData& l, int index)
     {
-        mDecals.resize(4);
-        mDecals[0].Load("data/decals/StarShape.png");
-        mDecals[1].Load("data/decals/RombShape.png");
-        mDecals[2].Load("data/decals/FourLines.png");
-        mDecals[3].Load("data/decals/Triangle.png");
+        std::shared_ptr<olc::Renderable> shape = mAssets.Load(decalFile(mShapeFiles[index]), nullptr, false, true, true);
+        if (!shape)
+            return nullptr;
+        // The same shape fills many cells, one handle keeps it resident
+        if (std::find(l.mAssets.begin(), l.mAssets.end(), shape) == l.mAssets.end())
+        {
+            l.mAssets.push_back(shape);
+        }
+        return shape->Decal();
     }
 
     int getNumLevels() const
@@ -368,12 +413,13 @@ public:
         }
         else
         {
-            l.mLevelGrid.push_back(mDecals[index].Decal());
+            l.mLevelGrid.push_back(getShape(l, index));
         }
     }
 
     LevelData loadLevel(int index)
     {
+        olc::ProfileZone zone("LevelLoader::loadLevel");
         LevelData l{};
         std::ifstream inFile(mLevelFiles[index]);
         if (inFile.is_open())
@@ -388,10 +434,10 @@ public:
             while ((pos = decalList.find(",")) != std::string::npos)
             {
                 std::string token = decalList.substr(0, pos);
-                l.mDecals.push_back(mDecals[std::atoi(token.c_str())].Decal());
+                l.mDecals.push_back(getShape(l, std::atoi(token.c_str())));
                 decalList.erase(0, pos + 1);
             }
-            l.mDecals.push_back(mDecals[std::atoi(decalList.c_str())].Decal());
+            l.mDecals.push_back(getShape(l, std::atoi(decalList.c_str())));
 
             std::string sizeStr;
             std::getline(inFile, sizeStr);
@@ -419,12 +465,20 @@ public:
             }
         }
 
+        // Only one level is resident at a time
+        size_t bytes = l.mDecals.capacity() * sizeof(olc::Decal*)
+            + l.mLevelGrid.capacity() * sizeof(olc::Decal*)
+            + l.mAssets.capacity() * sizeof(std::shared_ptr<olc::Renderable>);
+        olc::MemoryTracker::Set(mMemoryTag, bytes);
+
         return l;
     }
 
 private:
     std::vector<std::string> mLevelFiles;
-    std::vector<olc::Renderable> mDecals;
+    std::vector<std::string> mShapeFiles = { "StarShape", "RombShape", "FourLines", "Triangle" };
+    olc::AssetManager& mAssets;
+    uint32_t mMemoryTag = olc::MemoryTracker::RegisterTag("LevelData");
 
 };
 
@@ -451,7 +505,10 @@ public:
     }
 
     olc::SplashScreen mSplashScreen;
-    LevelLoader mLevelLoader = { "data/levels.txt" };
+    // F3 shows frame times, draw counts and uploads
+    olc::PerfOverlay mPerfOverlay;
+    olc::AssetManager mAssets = { 16 * 1024 * 1024 };
+    LevelLoader mLevelLoader = { "data/levels.txt", mAssets };
 
     olc::Pixel mBackgroundColor = { 255, 106, 0, 255 };
     ProgressBar mTimerBar = { {100,10}, {width - 200, 10}, 0.0f, 100.0f };
@@ -460,7 +517,7 @@ public:
 
     GameState mGameState = GameState::FadeIn;
 
-    olc::Renderable mGridTile;
+    std::shared_ptr<olc::Renderable> mGridTile;
 
     float mScrollCoolDown = 0.0f;
     const float mScrollTime = 0.05f;
@@ -470,9 +527,9 @@ public:
     int mMaxScore = 0;
 
     std::vector<olc::Renderable> mShapes;
-    olc::Renderable mIntro;
-    olc::Renderable mBackground;
-    olc::Renderable mDemoShape;
+    std::shared_ptr<olc::Renderable> mIntro;
+    std::shared_ptr<olc::Renderable> mBackground;
+    std::shared_ptr<olc::Renderable> mDemoShape;
 
     LevelData mLevelData;
 
@@ -483,34 +540,77 @@ public:
 public:
     bool OnUserCreate() override
     {
-        mIntro.Load("data/decals/Intro.png");
-        mBackground.Load("data/decals/Background.png");
+        // Warn if textures outgrow what the asset manager is meant to keep, plus the layer
+        olc::MemoryTracker::SetBudget(olc::MemoryTracker::TEXTURES, 24 * 1024 * 1024);
+
+        // Only the intro is faded on the CPU, everything else can live on the GPU alone
+        mIntro = mAssets.Load(decalFile("Intro"));
+        mBackground = mAssets.Load(decalFile("Background"), nullptr, false, true, true);
 
-        olc::vi2d size = mIntro.Sprite()->Size();
-        olc::Pixel* data = mIntro.Sprite()->GetData();
+        olc::vi2d size = mIntro->Sprite()->Size();
+        olc::Pixel* data = mIntro->Sprite()->GetData();
         for (int i = 0; i < size.x * size.y; i++)
         {
             data[i].a = 0;
         }
-        mIntro.Decal()->Update();
+        mIntro->Decal()->Update();
 
-        mDemoShape.Load("data/decals/StarShape.png");
-        mLevelLoader.loadDecals();
-        mGridTile.Load("data/decals/GridTile.png");
-        mPlayGrid.setTile(mGridTile.Decal());
+        mDemoShape = mAssets.Load(decalFile("StarShape"), nullptr, false, true, true);
+        mGridTile = mAssets.Load(decalFile("GridTile"), nullptr, false, true, true);
+        mPlayGrid.setTile(mGridTile->Decal());
 
         std::vector<olc::Decal*> dec;
         dec.resize(4 * 4, nullptr);
         mPlayGrid.loadData({ 4,4 }, dec);
-        mShapeBar.add(mDemoShape.Decal());
+        mShapeBar.add(mDemoShape->Decal());
 
         mTimerBar.setValue(50.0f);
-        mActiveBg = mIntro.Decal();
+        mActiveBg = mIntro->Decal();
         return true;
     }
 
     bool OnUserUpdate(float fElapsedTime) override
     {
+        // F9 starts a profiler capture, pressing it again stops it and writes a trace
+        // that can be opened in chrome://tracing
+        if (GetKey(olc::Key::F9).bPressed)
+        {
+            if (!olc::Profiler::IsEnabled())
+            {
+                olc::Profiler::Clear();
+                olc::Profiler::Enable(true);
+            }
+            else
+            {
+                olc::Profiler::Enable(false);
+                olc::Profiler::Dump("memory_trace.json");
+            }
+        }
+
+        // F10 reports memory use per subsystem
+        if (GetKey(olc::Key::F10).bPressed)
+        {
+            olc::MemoryTracker::Dump(std::cout);
+            olc::MemoryTracker::Dump("memory_report.txt");
+        }
+
+        // F11 starts measuring how long placing a shape takes to show, pressing it again
+        // stops and reports
+        if (GetKey(olc::Key::F11).bPressed)
+        {
+            if (!olc::LatencyTracker::IsEnabled())
+            {
+                olc::LatencyTracker::Clear();
+                olc::LatencyTracker::Enable(true);
+            }
+            else
+            {
+                olc::LatencyTracker::Enable(false);
+                olc::LatencyTracker::Dump(std::cout);
+                olc::LatencyTracker::Dump("latency_report.txt");
+            }
+        }
+
         //FillRectDecal({ 0,0 }, { width, height }, mBackgroundColor);
         DrawDecal({ 0,0 }, mActiveBg);
 
@@ -523,6 +623,10 @@ public:
             DrawStringPropDecal({ 10,25, }, scoreText);
         }
 
+        // Nothing moves on these screens until a key is pressed, and input wakes the pacer
+        SetSceneStatic(mGameState == GameState::Intro || mGameState == GameState::Tutorial ||
+            mGameState == GameState::WaitInput || mGameState == GameState::Score || mGameState == GameState::End);
+
         switch (mGameState)
         {
         case GameState::FadeIn:
@@ -533,13 +637,18 @@ public:
                 mFade = 0.5f;
                 mGameState = GameState::Intro;
             }
-            olc::vi2d size = mIntro.Sprite()->Size();
-            olc::Pixel* data = mIntro.Sprite()->GetData();
-            for (int i = 0; i < size.x * size.y; i++)
+            olc::vi2d size = mIntro->Sprite()->Size();
+            olc::Pixel* data = mIntro->Sprite()->GetData();
+            uint8_t alpha = uint8_t(2.0f * mFade * 255.0f);
+            // A band of rows per job
+            GetJobSystem().ParallelFor(0, uint32_t(size.y), 64, [&](uint32_t first, uint32_t last)
             {
-                data[i].a = int(2.0f * mFade * 255.0f);
-            }
-            mIntro.Decal()->Update();
+                for (int i = int(first) * size.x; i < int(last) * size.x; i++)
+                {
+                    data[i].a = alpha;
+                }
+            });
+            mIntro->Decal()->Update();
         }
         break;
         case GameState::Intro:
@@ -550,7 +659,7 @@ public:
             DrawStringPropDecal(pos, txt);
             if (GetKey(olc::Key::SPACE).bPressed)
             {
-                mActiveBg = mBackground.Decal();
+                mActiveBg = mBackground->Decal();
                 mGameState = GameState::Tutorial;
             }
         }
@@ -584,6 +693,9 @@ public:
         case GameState::Load:
         {
             mLevelData = mLevelLoader.loadLevel(mLevelIndex);
+            // Brings the manager back within its budget. The shipped shapes all fit
+            // with room to spare, so nothing is released unless bigger levels are added
+            mAssets.Collect();
             mGameState = GameState::WaitInput;
         }
         break;
@@ -655,13 +767,29 @@ public:
 
             mShapeBar.draw(this);
             mPlayGrid.hover(pos);
-            if (GetMouse(olc::Mouse::LEFT).bPressed)
+            // Every click since the last frame, on the tile it was made over, so none are
+            // lost or misplaced when a frame takes long
+            for (const olc::InputEvent& e : GetInputEvents())
             {
-                mPlayGrid.place(pos, mShapeBar.getSelectedDecal());
-            }
-            else if (GetMouse(olc::Mouse::RIGHT).bPressed)
-            {
-                mPlayGrid.place(pos, nullptr);
+                if (e.type != olc::InputEvent::Type::MOUSE_DOWN)
+                {
+                    continue;
+                }
+                olc::vi2d clickPos = mPlayGrid.transofrormCursor(e.vPos);
+                if (e.nCode == olc::Mouse::LEFT)
+                {
+                    mPlayGrid.place(clickPos, mShapeBar.getSelectedDecal());
+                }
+                else if (e.nCode == olc::Mouse::RIGHT)
+                {
+                    mPlayGrid.place(clickPos, nullptr);
+                }
+                else
+                {
+                    continue;
+                }
+                // The grid is drawn below, so this frame is the one that shows it
+                olc::LatencyTracker::MarkResponse(e.nTime, "PlayGrid::place");
             }
             mPlayGrid.draw(this);
 
@@ -725,9 +853,60 @@ public:
     }
 };
 
-int main()
+// Transcode every png in data/decals to QOI next to it, one file per job
+int convertDecals(olc::JobSystem& jobs)
+{
+    std::vector<_gfs::path> files;
+    for (const auto& entry : _gfs::directory_iterator("data/decals"))
+    {
+        if (entry.path().extension() == ".png")
+            files.push_back(entry.path());
+    }
+
+    // Reported afterwards in directory order, rather than however the jobs finish
+    std::vector<std::string> results(files.size());
+    std::atomic<int> failed{ 0 };
+    jobs.ParallelFor(0, uint32_t(files.size()), 1, [&](uint32_t first, uint32_t last)
+    {
+        for (uint32_t i = first; i < last; i++)
+        {
+            std::string src = files[i].string();
+            std::string dst = files[i].parent_path().string() + "/" + files[i].stem().string() + ".qoi";
+
+            olc::Sprite sprite;
+            if (sprite.LoadFromFile(src) != olc::rcode::OK || olc::Sprite::loader->SaveImageResource(&sprite, dst) != olc::rcode::OK)
+            {
+                results[i] = "Failed: " + src;
+                failed++;
+                continue;
+            }
+            results[i] = src + " -> " + dst + " (" + std::to_string(_gfs::file_size(src)) + " -> " + std::to_string(_gfs::file_size(dst)) + " bytes)";
+        }
+    });
+
+    for (const auto& line : results)
+        std::cout << line << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
 {
     Memory app;
+
+    // The engine is constructed first so the image loaders are set up
+    if (argc > 1 && std::string(argv[1]) == "--convert-qoi")
+        return convertDecals(app.GetJobSystem());
+
+    // Renders on the engine thread while the next frame is updated on another
+    if (argc > 1 && std::string(argv[1]) == "--pipelined")
+        app.EnablePipelinedRendering(true);
+
+    // Vsync is asked for, but not every driver honours it
+    app.SetFrameRateLimit(120.0f);
+    // Screens waiting for a key press are redrawn far less often
+    app.SetIdleFrameRate(15.0f);
+    app.EnableFrameTimeSmoothing(true);
+
     if (app.Construct(width, height, 2, 2, false, true))
         app.Start();
     return 0;
@@ -140,6 +140,102 @@
 
 
 
+	QOI Images
+	~~~~~~~~~~
+	Files ending in ".qoi" are loaded and saved by an in-tree implementation of the
+	"Quite OK Image" format, whatever image loader is configured. It decodes several
+	times faster than png and compresses flat shaded art about as well. Everything
+	else is passed on to the configured loader.
+
+
+
+	Decoded Image Cache
+	~~~~~~~~~~~~~~~~~~~
+	Decoding the same pngs at every launch is wasted effort. If you
+
+	#define OLC_IMAGE_CACHE
+
+	before including the olcPixelGameEngine.h header file, images loaded from disk are
+	stored decoded as raw RGBA in the folder OLC_IMAGE_CACHE_DIR (".pgecache" unless you
+	define it otherwise). Entries are keyed on path, file size and modification time, and
+	on later launches they are memory mapped instead of decoded. Images loaded from a
+	resource pack always go through the regular image loader.
+
+
+
+	Sprite Pixel Storage
+	~~~~~~~~~~~~~~~~~~~~
+	Sprite pixels come from olc::PixelPool, which hands out 64 byte aligned buffers
+	and keeps released ones for reuse, up to 64MB unless PixelPool::SetCacheLimit()
+	says otherwise. Because of this olc::Sprite::pColData is now a
+
+	std::vector<olc::Pixel, olc::PoolAllocator<olc::Pixel>>
+
+	rather than a plain std::vector<olc::Pixel>. Code that binds pColData to a
+	std::vector<olc::Pixel>& or passes it to a function taking one no longer
+	compiles. Use auto& or a reference to the new type, work through data() and
+	size(), or copy into a vector of your own with assign(begin(), end()).
+
+
+
+	Frame Statistics
+	~~~~~~~~~~~~~~~~
+	GetFrameStats() returns the decal instances, texture upload bytes and
+	allocations of the last frame submitted, and the draw calls the renderer
+	issued for the frame before it. Only pixel buffer allocations are
+	counted unless you
+
+	#define OLC_TRACK_ALLOCATIONS
+
+	before including the implementation, which replaces the global operator new so
+	every heap allocation is counted.
+
+
+
+	Job System
+	~~~~~~~~~~
+	GetJobSystem() returns a pool of worker threads, one fewer than the machine has
+	cores, that the engine's rasteriser also uses. ParallelFor() splits a range of
+	indices across them and returns when it is done. Schedule() runs a function in
+	the background once the jobs it depends on have finished, and Wait() blocks on
+	one, running other jobs meanwhile. Jobs must not draw to the screen or create
+	decals, as those belong to the engine thread, but they can record Draw*Decal
+	calls into an olc::DecalCommandBuffer each, which SubmitDecalCommands() adds to
+	the layers in a fixed order. The pool is stopped once OnUserDestroy() has
+	returned true.
+
+
+
+	Input Events
+	~~~~~~~~~~~~
+	GetKey() and GetMouse() report the state at the start of the frame. Alongside
+	them, GetInputEvents() lists every key, button, wheel and mouse movement the
+	platform reported since the previous frame, in order, each with its position and
+	a timestamp on the Profiler::Now() clock. Clicks made during a long frame are
+	all there, even if the button was released again before the next one. If more
+	arrive than the queue holds, the extra events are lost, and the keys, buttons
+	and mouse position catch up with the platform's latest state instead, with
+	one event for each key or button that ended up different.
+
+	Pass an event's timestamp to LatencyTracker::MarkResponse() in the frame that
+	shows its effect, and the time until that frame is displayed is recorded. When
+	enabled the engine does the same for every press under "Input". Dump() writes
+	percentiles and histograms; headless builds measure the engine's part alone.
+
+
+
+	Frame Pacing
+	~~~~~~~~~~~~
+	Without vsync, or where the driver ignores it, frames run as fast as they can.
+	SetFrameRateLimit() starts them at a steady rate instead, sleeping through most
+	of the wait and spinning for the last moment. SetIdleFrameRate() gives a lower
+	rate for while the application has said, with SetSceneStatic(), that nothing is
+	moving; any input brings the next frame forward. EnableFrameTimeSmoothing()
+	evens out the fElapsedTime passed to OnUserUpdate(), while GetFrameStats() still
+	reports the measured frame time.
+
+
+
 	Multiple cpp file projects?
 	~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	As a single header solution, the OLC_PGE_APPLICATION definition is used to
@@ -395,6 +491,13 @@ int main()
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <new>
+#include <cassert>
 #pragma endregion
 
 #define PGE_VER 223
@@ -439,6 +542,12 @@ int main()
 
 #define UNUSED(x) (void)(x)
 
+// SIMD kernels for the software renderer, elsewhere the scalar versions are used
+#if !defined(OLC_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define OLC_SSE2
+	#include <emmintrin.h>
+#endif
+
 // O------------------------------------------------------------------------------O
 // | PLATFORM SELECTION CODE, Thanks slavka!                                      |
 // O------------------------------------------------------------------------------O
@@ -532,6 +641,7 @@ int main()
 	{
 		#include <X11/X.h>
 		#include <X11/Xlib.h>
+		#include <X11/XKBlib.h>
 	}
 #endif
 
@@ -750,7 +860,14 @@ namespace olc
 	struct ResourceBuffer : public std::streambuf
 	{
 		ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size);
+		ResourceBuffer(const ResourceBuffer&) = delete;
+		ResourceBuffer(ResourceBuffer&& rb);
+		~ResourceBuffer();
 		std::vector<char> vMemory;
+
+	private:
+		// What was reported to MemoryTracker, vMemory may be moved out before destruction
+		size_t nTrackedBytes = 0;
 	};
 
 	class ResourcePack : public std::streambuf
@@ -782,6 +899,184 @@ namespace olc
 	};
 
 
+	// O------------------------------------------------------------------------------O
+	// | olc::PixelPool - Recycled, 64 byte aligned storage for sprite pixels         |
+	// O------------------------------------------------------------------------------O
+	class PixelPool
+	{
+	public:
+		// Buffers are rounded up to a size class, so a released buffer can serve any similar request
+		static void* Allocate(size_t nBytes);
+		static void Release(void* pBuffer, size_t nBytes);
+		// Released buffers are kept for reuse until they add up to this many bytes, default 64MB
+		static void SetCacheLimit(size_t nBytes);
+		// Frees every buffer waiting for reuse
+		static void Trim();
+		static size_t GetCachedBytes();
+		// Counts every buffer handed out since startup, recycled or not
+		static uint64_t GetAllocationCount();
+		static constexpr size_t nAlignment = 64;
+	};
+
+	template<class T>
+	struct PoolAllocator
+	{
+		typedef T value_type;
+		PoolAllocator() = default;
+		template<class U> PoolAllocator(const PoolAllocator<U>&) {}
+		T* allocate(size_t n) { return static_cast<T*>(PixelPool::Allocate(n * sizeof(T))); }
+		void deallocate(T* p, size_t n) { PixelPool::Release(p, n * sizeof(T)); }
+		template<class U> bool operator == (const PoolAllocator<U>&) const { return true; }
+		template<class U> bool operator != (const PoolAllocator<U>&) const { return false; }
+	};
+
+
+	// O------------------------------------------------------------------------------O
+	// | olc::Profiler - Timed zones captured for chrome://tracing                    |
+	// O------------------------------------------------------------------------------O
+	class Profiler
+	{
+	public:
+		// Zones are only recorded while enabled, a disabled zone costs one atomic load
+		static void Enable(bool bEnable);
+		static bool IsEnabled();
+		// Monotonic nanoseconds
+		static uint64_t Now();
+		// sName must outlive the capture, a string literal is expected. Safe from any thread,
+		// the newest 64k zones are kept
+		static void Record(const char* sName, uint64_t nStart, uint64_t nEnd);
+		// Forgets all zones recorded so far
+		static void Clear();
+		// Writes the captured zones as Chrome trace_event JSON
+		static bool Dump(const std::string& sFile);
+	};
+
+	// Records the time between its construction and destruction
+	class ProfileZone
+	{
+	public:
+		ProfileZone(const char* sZoneName) : sName(sZoneName), nStart(Profiler::IsEnabled() ? Profiler::Now() : 0) {}
+		~ProfileZone() { if (nStart != 0) Profiler::Record(sName, nStart, Profiler::Now()); }
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+	private:
+		const char* sName;
+		uint64_t nStart;
+	};
+
+
+	// O------------------------------------------------------------------------------O
+	// | olc::MemoryTracker - Bytes in use per subsystem, with budgets                |
+	// O------------------------------------------------------------------------------O
+	class MemoryTracker
+	{
+	public:
+		// Tags the engine reports against, applications can add their own with RegisterTag()
+		enum Tag : uint32_t { PIXELS, PIXEL_CACHE, TEXTURES, DECAL_QUEUES, RESOURCE_PACKS };
+		static constexpr uint32_t nMaxTags = 32;
+
+		// Returns the existing tag if the name is already registered
+		static uint32_t RegisterTag(const std::string& sName, size_t nBudgetBytes = 0);
+		// Safe from any thread
+		static void Allocate(uint32_t nTag, size_t nBytes);
+		static void Release(uint32_t nTag, size_t nBytes);
+		// Replaces the count, for things that are easier to measure than to follow
+		static void Set(uint32_t nTag, size_t nBytes);
+		// A budget of zero is unlimited. Going over it calls the warning handler once,
+		// it is armed again when the tag drops back within budget
+		static void SetBudget(uint32_t nTag, size_t nBytes);
+		static void SetWarningHandler(std::function<void(const std::string&)> handler);
+		static size_t GetCurrent(uint32_t nTag);
+		static size_t GetPeak(uint32_t nTag);
+		// Writes a table of every tag's current, peak and budget bytes
+		static void Dump(std::ostream& os);
+		static bool Dump(const std::string& sFile);
+	};
+
+
+	// O------------------------------------------------------------------------------O
+	// | olc::LatencyTracker - Time from an input to the frame that shows its effect  |
+	// O------------------------------------------------------------------------------O
+	class LatencyTracker
+	{
+	public:
+		// While enabled the engine also records every key and button press under "Input",
+		// measured to the display of the frame that first saw it
+		static void Enable(bool bEnable);
+		static bool IsEnabled();
+		// Call from OnUserUpdate when the effect of an input stamped nInputTime is drawn,
+		// it is measured when this frame is displayed. sName must outlive the tracker,
+		// a string literal is expected
+		static void MarkResponse(uint64_t nInputTime, const char* sName);
+		// Milliseconds from input to display at fPercentile (0 to 1) of the newest 64k
+		// samples under sName, 0 if there are none
+		static float GetPercentile(const std::string& sName, float fPercentile);
+		// Drops all samples, and responses still waiting for their frame to be displayed
+		static void Clear();
+		// Writes percentiles and a histogram for each name
+		static void Dump(std::ostream& os);
+		static bool Dump(const std::string& sFile);
+	};
+
+
+	// O------------------------------------------------------------------------------O
+	// | olc::JobSystem - Work stealing thread pool for fork-join and task graphs     |
+	// O------------------------------------------------------------------------------O
+	struct Job;
+	struct JobQueue;
+	// Refers to a scheduled job, it can be waited on or depended upon
+	typedef std::shared_ptr<olc::Job> JobHandle;
+
+	class JobSystem
+	{
+	public:
+		JobSystem() = default;
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+	public:
+		// Starts nWorkers threads, 0 sizes the pool from the hardware leaving a core for
+		// the calling thread. Happens on first use if not called before
+		void Start(uint32_t nWorkers = 0);
+		// Finishes every job that can still run, then joins the workers. Jobs whose
+		// dependencies can never complete are dropped
+		void Stop();
+		uint32_t GetWorkerCount() const;
+
+		// Runs func once every job in vDependencies has finished, null handles are ignored
+		olc::JobHandle Schedule(std::function<void()> func, const std::vector<olc::JobHandle>& vDependencies = {});
+		// Returns once job has finished, running other jobs meanwhile, so it is safe to
+		// call from within a job
+		void Wait(const olc::JobHandle& job);
+		static bool IsDone(const olc::JobHandle& job);
+		// Calls func(nFirst, nLast) for consecutive ranges of at most nGrain indices that
+		// together cover [nBegin, nEnd), shared between the workers and the calling thread.
+		// Returns when all are done
+		void ParallelFor(uint32_t nBegin, uint32_t nEnd, uint32_t nGrain, const std::function<void(uint32_t, uint32_t)>& func);
+
+	private:
+		void WorkerThread(uint32_t nIndex);
+		uint32_t QueueIndex() const;
+		bool RunOne(uint32_t nQueue);
+		void Push(olc::JobHandle job);
+		void Finish(olc::Job& job);
+		void Wake();
+
+	private:
+		// One per worker, plus one shared by every other thread
+		std::vector<std::unique_ptr<olc::JobQueue>> vQueues;
+		std::vector<std::thread> vWorkers;
+		std::mutex muxStart;
+		std::mutex muxSleep;
+		std::condition_variable cvSleep;
+		std::atomic<uint32_t> nQueued{ 0 };
+		std::atomic<uint32_t> nSleeping{ 0 };
+		std::atomic<bool> bRunning{ false };
+		bool bQuit = false;
+	};
+
+
 	// O------------------------------------------------------------------------------O
 	// | olc::Sprite - An image represented by a 2D array of olc::Pixel               |
 	// O------------------------------------------------------------------------------O
@@ -793,6 +1088,8 @@ namespace olc
 		Sprite(int32_t w, int32_t h);
 		Sprite(const olc::Sprite&) = delete;
 		~Sprite();
+		// Copies the pixels, size, sample mode and mip chain
+		olc::Sprite& operator=(const olc::Sprite& spr);
 
 	public:
 		olc::rcode LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack = nullptr);
@@ -802,6 +1099,7 @@ namespace olc
 		int32_t height = 0;
 		enum Mode { NORMAL, PERIODIC, CLAMP };
 		enum Flip { NONE = 0, HORIZ = 1, VERT = 2 };
+		enum Filter { NEAREST, BILINEAR };
 
 	public:
 		void SetSampleMode(olc::Sprite::Mode mode = olc::Sprite::Mode::NORMAL);
@@ -813,14 +1111,32 @@ namespace olc
 		Pixel Sample(const olc::vf2d& uv) const;
 		Pixel SampleBL(float u, float v) const;
 		Pixel SampleBL(const olc::vf2d& uv) const;
+		// Samples nCount coordinates (pU[i], pV[i]) into pOut, giving the same results as
+		// Sample() or SampleBL() but with the sample mode and filter resolved once per call
+		void SampleSpan(const float* pU, const float* pV, Pixel* pOut, int32_t nCount, olc::Sprite::Filter filter = olc::Sprite::Filter::NEAREST) const;
+		// Builds a chain of box filtered copies, each half the size of the one before, down to 1x1.
+		// The chain is a snapshot, Decal::Update() rebuilds it along with the texture
+		void GenerateMips();
+		void ClearMips();
+		// Levels in the chain, counting the sprite itself as level 0
+		size_t GetMipCount() const;
+		const olc::Sprite* GetMip(size_t nLevel) const;
+		// The level to sample when each pixel drawn spans fTexelsPerPixel of this sprite's texels
+		const olc::Sprite* GetMipForScale(float fTexelsPerPixel) const;
 		Pixel* GetData();
 		olc::Sprite* Duplicate();
 		olc::Sprite* Duplicate(const olc::vi2d& vPos, const olc::vi2d& vSize);
 		olc::vi2d Size() const;
-		std::vector<olc::Pixel> pColData;
+		// Not a plain std::vector<olc::Pixel>, see "Sprite Pixel Storage" at the top of this file
+		std::vector<olc::Pixel, olc::PoolAllocator<olc::Pixel>> pColData;
 		Mode modeSample = Mode::NORMAL;
 
 		static std::unique_ptr<olc::ImageLoader> loader;
+
+	private:
+		std::vector<std::unique_ptr<olc::Sprite>> vMips;
+		template<olc::Sprite::Mode mode> Pixel Fetch(int32_t x, int32_t y) const;
+		template<olc::Sprite::Filter filter, olc::Sprite::Mode mode> void SampleSpan(const float* pU, const float* pV, Pixel* pOut, int32_t nCount) const;
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -829,16 +1145,21 @@ namespace olc
 	class Decal
 	{
 	public:
-		Decal(olc::Sprite* spr, bool filter = false, bool clamp = true);
+		// With gpuonly set the sprite's pixels are released once uploaded, it keeps its size.
+		// With mipmap set a mip chain is built and uploaded with it, for drawing at reduced scales
+		Decal(olc::Sprite* spr, bool filter = false, bool clamp = true, bool gpuonly = false, bool mipmap = false);
 		Decal(const uint32_t nExistingTextureResource, olc::Sprite* spr);
 		virtual ~Decal();
 		void Update();
+		// Reads the texture back into the sprite, restoring its pixels if they were released
 		void UpdateSprite();
 
 	public: // But dont touch
 		int32_t id = -1;
 		olc::Sprite* sprite = nullptr;
 		olc::vf2d vUVScale = { 1.0f, 1.0f };
+		bool bMipmap = false;
+		size_t nTextureBytes = 0;
 	};
 
 	enum class DecalMode
@@ -869,7 +1190,11 @@ namespace olc
 		Renderable() = default;		
 		Renderable(Renderable&& r) : pSprite(std::move(r.pSprite)), pDecal(std::move(r.pDecal)) {}		
 		Renderable(const Renderable&) = delete;
-		olc::rcode Load(const std::string& sFile, ResourcePack* pack = nullptr, bool filter = false, bool clamp = true);
+		// Set gpuonly if the sprite's pixels are never needed on the CPU, see olc::Decal
+		olc::rcode Load(const std::string& sFile, ResourcePack* pack = nullptr, bool filter = false, bool clamp = true, bool gpuonly = false, bool mipmap = false);
+		// Loads the sprite on the calling thread, but defers decal creation to the engine thread.
+		// Do not touch the Renderable until the returned future is ready
+		std::future<olc::rcode> LoadDeferred(const std::string& sFile, ResourcePack* pack = nullptr, bool filter = false, bool clamp = true, bool gpuonly = false, bool mipmap = false);
 		void Create(uint32_t width, uint32_t height, bool filter = false, bool clamp = true);
 		olc::Decal* Decal() const;
 		olc::Sprite* Sprite() const;
@@ -896,6 +1221,66 @@ namespace olc
 		uint32_t points = 0;
 	};
 
+	// Records Draw*Decal calls made away from the engine thread, e.g. from jobs. Between
+	// Begin() and End(), decal drawing and SetDecalMode/Structure() on the calling thread
+	// go to the buffer instead of the layers. PixelGameEngine::SubmitDecalCommands() then
+	// appends them to the layers on the engine thread
+	class DecalCommandBuffer
+	{
+	public:
+		// Starts recording on the calling thread against nLayer, in NORMAL mode with FAN structure.
+		// Only one buffer may record on a thread at once. Other jobs the thread runs while it waits
+		// are not recorded, unless they were scheduled under this same recording, such as the parts
+		// of a ParallelFor() called while recording. Those parts may run on other threads too, where
+		// drawing decals asserts, so call a ParallelFor() that draws outside of a recording and
+		// Begin() a buffer in each part
+		void Begin(uint8_t nLayer = 0);
+		// Stops recording on the calling thread
+		void End();
+		// Changes the layer later calls are recorded against
+		void SetLayer(uint8_t nLayer);
+		void Clear();
+		bool IsEmpty() const;
+
+	private:
+		friend class PixelGameEngine;
+		uint8_t nLayer = 0;
+		olc::DecalMode nMode = olc::DecalMode::NORMAL;
+		olc::DecalStructure nStructure = olc::DecalStructure::FAN;
+		// Each instance with the layer it was recorded against, in call order
+		std::vector<std::pair<uint8_t, olc::DecalInstance>> vCommands;
+	};
+
+	// A change of input as the platform reported it, see PixelGameEngine::GetInputEvents()
+	struct InputEvent
+	{
+		enum class Type : uint8_t { KEY_DOWN, KEY_UP, MOUSE_DOWN, MOUSE_UP, MOUSE_MOVE, MOUSE_WHEEL };
+		Type type = Type::MOUSE_MOVE;
+		// olc::Key for keys, olc::Mouse button for buttons, delta for the wheel
+		int32_t nCode = 0;
+		// Mouse position in screen pixels at the time
+		olc::vi2d vPos;
+		// Nanoseconds on the Profiler::Now() clock
+		uint64_t nTime = 0;
+	};
+
+	// Counters gathered over one frame, see PixelGameEngine::GetFrameStats()
+	struct FrameStats
+	{
+		float fFrameTime = 0.0f;
+		uint32_t nDecalInstances = 0;
+		// Draws the renderer issued for the frame displayed before this one, hooked layers
+		// included as far as they draw through the renderer
+		uint32_t nDrawCalls = 0;
+		uint64_t nUploadBytes = 0;
+		uint32_t nPixelAllocations = 0;
+		// Always zero unless OLC_TRACK_ALLOCATIONS is defined
+		uint32_t nHeapAllocations = 0;
+		// Indexed by layer
+		std::vector<uint32_t> vLayerDecalInstances;
+		std::vector<uint32_t> vLayerDrawCalls;
+	};
+
 	struct LayerDesc
 	{
 		olc::vf2d vOffset = { 0, 0 };
@@ -909,6 +1294,38 @@ namespace olc
 		std::function<void()> funcHook = nullptr;
 	};
 
+	// Everything needed to draw one frame, taken from the layers once the update is done
+	struct FramePacket
+	{
+		struct Layer
+		{
+			bool bShow = false;
+			olc::vf2d vOffset = { 0, 0 };
+			olc::vf2d vScale = { 1, 1 };
+			olc::Pixel tint = olc::WHITE;
+			std::function<void()> funcHook = nullptr;
+			olc::Decal* pDecal = nullptr;
+			// Pixels to upload to pDecal before drawing, nullptr if the layer is unchanged
+			olc::Sprite* pUpload = nullptr;
+			// Copy of the layer's pixels when rendering on another thread
+			std::unique_ptr<olc::Sprite> pStaging;
+			std::vector<DecalInstance> vecDecalInstance;
+			// Draws the renderer issued for this layer, filled in as it is rendered
+			uint32_t nDrawCalls = 0;
+		};
+
+		std::vector<Layer> vLayers;
+		// Texture work recorded during the update, carried out before drawing
+		std::vector<std::function<void()>> vCommands;
+		olc::vi2d vViewPos = { 0, 0 };
+		olc::vi2d vViewSize = { 0, 0 };
+		// Responses marked during the update, see LatencyTracker
+		std::vector<std::pair<const char*, std::array<uint64_t, 2>>> vLatencyMarks;
+	};
+
+	struct PipelineState;
+	struct InputRing;
+
 	class Renderer
 	{
 	public:
@@ -923,12 +1340,19 @@ namespace olc
 		virtual void       DrawDecal(const olc::DecalInstance& decal) = 0;
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false, const bool clamp = true) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
+		// Uploads the sprite and its mip chain, renderers without mip support upload the sprite only
+		virtual void       UpdateTextureMips(uint32_t id, olc::Sprite* spr) { UpdateTexture(id, spr); }
 		virtual void       ReadTexture(uint32_t id, olc::Sprite* spr) = 0;
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
 		virtual void       ClearBuffer(olc::Pixel p, bool bDepth) = 0;
+		// Draws issued to the device so far, renderers count each one as they issue it
+		virtual uint32_t   GetDrawCalls() const { return nDrawCalls; }
 		static olc::PixelGameEngine* ptrPGE;
+
+	protected:
+		uint32_t nDrawCalls = 0;
 	};
 
 	class Platform
@@ -966,6 +1390,22 @@ namespace olc
 		olc::rcode Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h,
 			bool full_screen = false, bool vsync = false, bool cohesion = false);
 		olc::rcode Start();
+		// Draws each frame on a thread of its own while the next frame is updated. The render
+		// thread keeps the graphics context, so texture work done during the update is passed
+		// over to it. Call before Start(), only platforms that run the engine on its own thread
+		// support this (Windows, Linux and headless)
+		void EnablePipelinedRendering(bool bEnable);
+		// Starts frames no more often than this, 0 (the default) runs them as fast as possible.
+		// Most of the wait is slept and the last part spun, so each frame starts on time
+		void SetFrameRateLimit(float fFramesPerSecond);
+		// While the scene is marked static and no input arrives, frames run at this rate
+		// instead, 0 (the default) keeps the normal rate. Input wakes the pacer straight away
+		void SetIdleFrameRate(float fFramesPerSecond);
+		// Tells the pacer whether the coming frames would look the same as this one
+		void SetSceneStatic(bool bStatic);
+		// Passes OnUserUpdate() a running average of frame times instead of the last one
+		// alone. Whatever the average gains or loses against real time is paid back slowly
+		void EnableFrameTimeSmoothing(bool bEnable);
 
 	public: // User Override Interfaces
 		// Called once on application startup, use to load your resources
@@ -1021,6 +1461,13 @@ namespace olc
 		uint32_t GetFPS() const;
 		// Gets last update of elapsed time
 		float GetElapsedTime() const;
+		// Gets the counters of the last frame displayed
+		const olc::FrameStats& GetFrameStats() const;
+		// Gets the input received since the previous frame, oldest first. Unlike the polled
+		// state, a press and release within one frame both show up, in order
+		const std::vector<olc::InputEvent>& GetInputEvents() const;
+		// Gets the engine's thread pool, for work to share out across cores
+		olc::JobSystem& GetJobSystem();
 		// Gets Actual Window size
 		const olc::vi2d& GetWindowSize() const;
 		// Gets pixel scale
@@ -1095,6 +1542,24 @@ namespace olc
 		// selected area is (ox,oy) to (ox+w,oy+h)
 		void DrawPartialSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 		void DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
+		// Draws a sprite through an affine transform, which maps sprite pixel coordinates to the draw
+		// target as (m[0] * x + m[1] * y + m[2], m[3] * x + m[4] * y + m[5])
+		void DrawTransformedSprite(const std::array<float, 6>& m, Sprite* sprite, olc::Sprite::Filter filter = olc::Sprite::Filter::NEAREST);
+		// Draws a sprite rotated by fAngle radians about center, which is placed at pos
+		void DrawRotatedSprite(const olc::vf2d& pos, Sprite* sprite, const float fAngle, const olc::vf2d& center = { 0.0f, 0.0f }, const olc::vf2d& scale = { 1.0f, 1.0f }, olc::Sprite::Filter filter = olc::Sprite::Filter::NEAREST);
+		// Draws a sprite through a span shader instead of the pixel mode. A shader is any callable
+		// taking (const olc::Pixel* pSource, olc::Pixel* pDest, int32_t nCount), it is called once
+		// per clipped row with the source pixels and the draw target pixels they land on
+		template<typename Shader>
+		void DrawSpriteShaded(int32_t x, int32_t y, const Sprite* sprite, Shader&& shader, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE)
+		{ if (sprite != nullptr) DrawPartialSpriteShaded(x, y, sprite, 0, 0, sprite->width, sprite->height, shader, scale, flip); }
+		template<typename Shader>
+		void DrawPartialSpriteShaded(int32_t x, int32_t y, const Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, Shader&& shader, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE)
+		{ if (sprite != nullptr) BlitSprite(x, y, sprite, ox, oy, w, h, scale, flip, &SpanThunk<std::remove_reference_t<Shader>>, (void*)std::addressof(shader)); }
+		// Fills a rectangle at (x,y) to (x+w,y+h) through a span shader, every source pixel is p
+		template<typename Shader>
+		void FillRectShaded(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p, Shader&& shader)
+		{ FillRectSpans(x, y, w, h, p, &SpanThunk<std::remove_reference_t<Shader>>, (void*)std::addressof(shader)); }
 		// Draws a single line of text - traditional monospaced
 		void DrawString(int32_t x, int32_t y, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		void DrawString(const olc::vi2d& pos, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
@@ -1107,6 +1572,11 @@ namespace olc
 		// Decal Quad functions
 		void SetDecalMode(const olc::DecalMode& mode);
 		void SetDecalStructure(const olc::DecalStructure& structure);
+		// Appends the decals recorded by other threads to the layers, buffer by buffer in the
+		// order given, each in the order it was recorded, then clears the buffers. Call from
+		// the engine thread once recording has finished
+		void SubmitDecalCommands(olc::DecalCommandBuffer& buffer);
+		void SubmitDecalCommands(std::vector<olc::DecalCommandBuffer>& vBuffers);
 		// Draws a whole decal, with optional scale and tinting
 		void DrawDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
 		// Draws a region of a decal, with optional scale and tinting
@@ -1168,11 +1638,65 @@ namespace olc
 		int32_t TextEntryGetCursor() const;
 		bool IsTextEntryEnabled() const;
 
+		// Deferred GPU Routines - these may be called from any thread, the work is
+		// carried out on the engine thread at the start of a subsequent frame
+		std::future<std::unique_ptr<olc::Decal>> QueueDecalCreate(olc::Sprite* spr, bool filter = false, bool clamp = true);
+		std::future<void> QueueDecalUpdate(olc::Decal* decal);
+		// Destroying a decal deletes its texture, which must happen on the engine thread.
+		// Decals created with QueueDecalCreate() and released elsewhere are handed back here
+		std::future<void> QueueDecalDestroy(std::unique_ptr<olc::Decal> decal);
+		std::future<void> QueueGPUTask(std::function<void()> task, size_t nUploadBytes = 0);
+		// Limits bytes uploaded by queued work per frame, 0 = unlimited. At least
+		// one queued task is always processed per frame so the queue cannot stall
+		void SetGPUUploadBudget(const size_t nBytesPerFrame);
 
 
 	private:
 		void UpdateTextEntry();
 		void UpdateConsole();
+		void ProcessGPUTasks();
+		// Writes a row of pixels to the draw target using the current pixel mode, no bounds checking
+		void BlendSpan(olc::Pixel* pDst, const olc::Pixel* pSrc, int32_t nCount);
+		// Span shaders are called through a plain function pointer, instantiated per shader type
+		typedef void (*SpanFunc)(void* pShader, const olc::Pixel* pSource, olc::Pixel* pDest, int32_t nCount);
+		template<typename Shader>
+		static void SpanThunk(void* pShader, const olc::Pixel* pSource, olc::Pixel* pDest, int32_t nCount)
+		{ (*static_cast<Shader*>(pShader))(pSource, pDest, nCount); }
+		// Clips once then blits whole rows, through fnSpan if given, otherwise using the pixel
+		// mode. Returns false if the per pixel path is required, which never happens with fnSpan
+		bool BlitSprite(int32_t x, int32_t y, const olc::Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale, uint8_t flip, SpanFunc fnSpan = nullptr, void* pShader = nullptr);
+		// Clips a rectangle like FillRect() and passes each row of it to fnSpan
+		void FillRectSpans(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p, SpanFunc fnSpan, void* pShader);
+		// Fills a row of the draw target with one colour using the current pixel mode, no bounds checking
+		void FillSpan(olc::Pixel* pDst, olc::Pixel p, int32_t nNumPixels);
+		// Fills [x1, x2] of row y, clipped to the draw target
+		void DrawSpan(int32_t x1, int32_t x2, int32_t y, Pixel p);
+		// Draws columns [nFirst, nFirst + nWidth) of a glyph mask as clipped spans
+		void DrawGlyph(int32_t x, int32_t y, uint64_t nMask, int32_t nFirst, int32_t nWidth, Pixel col, uint32_t scale);
+
+		// Screen space triangle prepared for the tile rasteriser
+		struct RasterTriangle
+		{
+			// Edge functions in 28.4 fixed point, a pixel is inside when A * x + B * y + C >= 0 for all three
+			int64_t A[3], B[3], C[3];
+			// Pixel bounds [x0, x1) x [y0, y1), clipped to the draw target
+			int32_t x0, y0, x1, y1;
+			// Attribute planes, value at pixel (x, y) = v + x * dx + y * dy. Colour is 16.16 fixed point
+			int64_t nCol[4][3];
+			double fTex[2][3];
+		};
+
+		// Decal mode, structure and queue for the calling thread, see DecalCommandBuffer
+		olc::DecalMode& olc_DecalMode();
+		olc::DecalStructure& olc_DecalStructure();
+		void olc_PushDecal(olc::DecalInstance&& di);
+
+		// Snaps, orients and clips a triangle, returns false if it covers no pixels
+		bool SetupTriangle(const olc::vf2d* pPos, const olc::vf2d* pTex, const olc::Pixel* pCol, RasterTriangle& tri) const;
+		// Bins triangles into screen tiles and fills the tiles in parallel, in submission order within each tile
+		void RasteriseTriangles(const std::vector<RasterTriangle>& vTris, const olc::Sprite* sprTex);
+		// Fills the part of a triangle that lies within [x0, x1) x [y0, y1)
+		void RasteriseTile(const RasterTriangle& tri, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const olc::Sprite* sprTex);
 
 	public:
 
@@ -1217,7 +1741,6 @@ namespace olc
 		int32_t		nMouseWheelDelta = 0;
 		olc::vi2d	vMousePosCache = { 0, 0 };
 		olc::vi2d   vMouseWindowPos = { 0, 0 };
-		int32_t		nMouseWheelDeltaCache = 0;
 		olc::vi2d	vWindowSize = { 0, 0 };
 		olc::vi2d	vViewPos = { 0, 0 };
 		olc::vi2d	vViewSize = { 0,0 };
@@ -1234,11 +1757,14 @@ namespace olc
 		std::vector<LayerDesc> vLayers;
 		uint8_t		nTargetLayer = 0;
 		uint32_t	nLastFPS = 0;
+		olc::FrameStats statsFrame;
 		bool        bPixelCohesion = false;
 		DecalMode   nDecalMode = DecalMode::NORMAL;
 		DecalStructure nDecalStructure = DecalStructure::FAN;
+		// The thread that owns the layers, decals drawn elsewhere must go to a DecalCommandBuffer
+		std::thread::id idUpdateThread;
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
-		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
+		std::chrono::time_point<std::chrono::steady_clock> m_tp1, m_tp2;
 		std::vector<olc::vi2d> vFontSpacing;
 		std::vector<std::string> vDroppedFiles;
 		std::vector<std::string> vDroppedFilesCache;
@@ -1264,18 +1790,60 @@ namespace olc
 		int32_t nTextEntryCursor = 0;
 		std::vector<std::tuple<olc::Key, std::string, std::string>> vKeyboardMap;
 
-
-
-		// State of keyboard		
-		bool		pKeyNewState[256] = { 0 };
+		// Deferred GPU Specific
+		struct GPUTask { size_t nBytes; std::function<void()> func; };
+		std::mutex muxGPUTasks;
+		std::deque<GPUTask> qGPUTasks;
+		size_t nGPUUploadBudget = 0;
+
+		// Software Blitter Specific
+		std::vector<olc::Pixel> vBlitSpan;
+
+		// Software Rasteriser Specific
+		std::vector<RasterTriangle> vRasterTris;
+		std::vector<std::vector<uint32_t>> vRasterBins;
+		std::vector<uint32_t> vRasterTiles;
+		// Pipelined rendering, see EnablePipelinedRendering()
+		bool bPipelinedRendering = false;
+		olc::FramePacket framePacket;
+		std::unique_ptr<olc::PipelineState> pPipeline;
+
+		// Shared by the rasteriser and the application, stopped after OnUserDestroy()
+		olc::JobSystem jobs;
+
+		// Frame Pacing Specific
+		float fFrameRateLimit = 0.0f;
+		float fIdleFrameRate = 0.0f;
+		bool bSceneStatic = false;
+		bool bFrameTimeSmoothing = false;
+		float fFrameTimeAverage = 0.0f;
+		float fFrameTimeDebt = 0.0f;
+		std::chrono::steady_clock::time_point tpFrameStart;
+		std::chrono::steady_clock::duration durSleepOvershoot = std::chrono::milliseconds(1);
+		void olc_PaceFrame();
+
+
+
+		// State of keyboard. The new states are the last the platform reported, written on
+		// whichever thread it reports on, and only read by the engine to recover from overflow
+		std::atomic<bool> pKeyNewState[256] = {};
 		bool		pKeyOldState[256] = { 0 };
 		HWButton	pKeyboardState[256] = { 0 };
 
 		// State of mouse
-		bool		pMouseNewState[nMouseButtons] = { 0 };
+		std::atomic<bool> pMouseNewState[nMouseButtons] = {};
 		bool		pMouseOldState[nMouseButtons] = { 0 };
 		HWButton	pMouseState[nMouseButtons] = { 0 };
 
+		// Input from the platform, which may run on another thread, see GetInputEvents()
+		std::unique_ptr<olc::InputRing> pInputRing;
+		std::vector<olc::InputEvent> vInputEvents;
+		uint32_t nInputDropped = 0;
+		// Time of the newest event delivered, given to events standing in for dropped ones
+		uint64_t nInputLastTime = 0;
+		void olc_PushInput(olc::InputEvent::Type type, int32_t nCode);
+		void olc_ProcessInput();
+
 		// The main engine thread
 		void		EngineThread();
 
@@ -1292,6 +1860,9 @@ namespace olc
 		void olc_UpdateViewport();
 		void olc_ConstructFontSheet();
 		void olc_CoreUpdate();
+		void olc_SubmitFrame();
+		void olc_RenderFrame(olc::FramePacket& packet);
+		void olc_PipelinedLoop();
 		void olc_PrepareEngine();
 		void olc_UpdateMouseState(int32_t button, bool state);
 		void olc_UpdateKeyState(int32_t key, bool state);
@@ -1383,6 +1954,10 @@ namespace olc
 		#define GL_CLAMP GL_CLAMP_TO_EDGE
 	#endif
 
+	#if !defined(GL_TEXTURE_MAX_LEVEL)
+		#define GL_TEXTURE_MAX_LEVEL 0x813D
+	#endif
+
 namespace olc
 {
 	typedef char GLchar;
@@ -1568,187 +2143,1236 @@ namespace olc
 	{ return (p2 * t) + p1 * (1.0f - t); }
 
 	// O------------------------------------------------------------------------------O
-	// | olc::Sprite IMPLEMENTATION                                                   |
+	// | olc::PixelPool IMPLEMENTATION                                                |
 	// O------------------------------------------------------------------------------O
-	Sprite::Sprite()
-	{ width = 0; height = 0; }
-
-	Sprite::Sprite(const std::string& sImageFile, olc::ResourcePack* pack)
-	{ LoadFromFile(sImageFile, pack); }
+	struct PixelPoolState
+	{
+		std::mutex mux;
+		std::unordered_map<size_t, std::vector<void*>> mapFree;
+		size_t nCached = 0;
+		size_t nLimit = 64 * 1024 * 1024;
+		std::atomic<uint64_t> nAllocations{ 0 };
+	};
 
-	Sprite::Sprite(int32_t w, int32_t h)
-	{		
-		width = w;		height = h;
-		pColData.resize(width * height);
-		pColData.resize(width * height, nDefaultPixel);
+	// Never destroyed, sprites with static lifetime may release buffers after main() returns
+	static PixelPoolState& GetPixelPool()
+	{
+		static PixelPoolState* pool = new PixelPoolState;
+		return *pool;
 	}
 
-	Sprite::~Sprite()
-	{ pColData.clear();	}
-
-	void Sprite::SetSampleMode(olc::Sprite::Mode mode)
-	{ modeSample = mode; }
-
-	Pixel Sprite::GetPixel(const olc::vi2d& a) const
-	{ return GetPixel(a.x, a.y); }
-
-	bool Sprite::SetPixel(const olc::vi2d& a, Pixel p)
-	{ return SetPixel(a.x, a.y, p); }
+	static size_t PixelPoolClass(size_t nBytes)
+	{
+		// In 64 byte units, with four classes per power of two above 256 bytes so
+		// rounding never wastes more than a quarter of the buffer
+		size_t nUnits = std::max<size_t>((nBytes + PixelPool::nAlignment - 1) / PixelPool::nAlignment, 1);
+		size_t nStep = 1;
+		while (nStep * 8 < nUnits) nStep <<= 1;
+		return (nUnits + nStep - 1) / nStep * nStep * PixelPool::nAlignment;
+	}
 
-	Pixel Sprite::GetPixel(int32_t x, int32_t y) const
+	void* PixelPool::Allocate(size_t nBytes)
 	{
-		if (modeSample == olc::Sprite::Mode::NORMAL)
+		const size_t nClass = PixelPoolClass(nBytes);
+		PixelPoolState& pool = GetPixelPool();
+		pool.nAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		// The tracker is told once the lock is released, a budget warning handler
+		// is free to create sprites of its own
+		void* p = nullptr;
 		{
-			if (x >= 0 && x < width && y >= 0 && y < height)
-				return pColData[y * width + x];
-			else
-				return Pixel(0, 0, 0, 0);
+			std::unique_lock<std::mutex> lock(pool.mux);
+			auto it = pool.mapFree.find(nClass);
+			if (it != pool.mapFree.end() && !it->second.empty())
+			{
+				p = it->second.back();
+				it->second.pop_back();
+				pool.nCached -= nClass;
+			}
 		}
+		if (p != nullptr)
+			MemoryTracker::Release(MemoryTracker::PIXEL_CACHE, nClass);
 		else
+			p = ::operator new(nClass, std::align_val_t(nAlignment));
+		MemoryTracker::Allocate(MemoryTracker::PIXELS, nClass);
+		return p;
+	}
+
+	void PixelPool::Release(void* pBuffer, size_t nBytes)
+	{
+		if (pBuffer == nullptr) return;
+		const size_t nClass = PixelPoolClass(nBytes);
+		PixelPoolState& pool = GetPixelPool();
+		MemoryTracker::Release(MemoryTracker::PIXELS, nClass);
+		bool bCached = false;
 		{
-			if (modeSample == olc::Sprite::Mode::PERIODIC)
-				return pColData[abs(y % height) * width + abs(x % width)];
-			else
-				return pColData[std::max(0, std::min(y, height-1)) * width + std::max(0, std::min(x, width-1))];
+			std::unique_lock<std::mutex> lock(pool.mux);
+			if (pool.nCached + nClass <= pool.nLimit)
+			{
+				pool.mapFree[nClass].push_back(pBuffer);
+				pool.nCached += nClass;
+				bCached = true;
+			}
 		}
+		if (bCached)
+			MemoryTracker::Allocate(MemoryTracker::PIXEL_CACHE, nClass);
+		else
+			::operator delete(pBuffer, std::align_val_t(nAlignment));
 	}
 
-	bool Sprite::SetPixel(int32_t x, int32_t y, Pixel p)
+	void PixelPool::SetCacheLimit(size_t nBytes)
 	{
-		if (x >= 0 && x < width && y >= 0 && y < height)
+		PixelPoolState& pool = GetPixelPool();
 		{
-			pColData[y * width + x] = p;
-			return true;
+			std::unique_lock<std::mutex> lock(pool.mux);
+			pool.nLimit = nBytes;
+			if (pool.nCached <= nBytes) return;
 		}
-		else
-			return false;
+		Trim();
 	}
 
-	Pixel Sprite::Sample(float x, float y) const
+	void PixelPool::Trim()
 	{
-		int32_t sx = std::min((int32_t)((x * (float)width)), width - 1);
-		int32_t sy = std::min((int32_t)((y * (float)height)), height - 1);
-		return GetPixel(sx, sy);
+		PixelPoolState& pool = GetPixelPool();
+		size_t nFreed = 0;
+		{
+			std::unique_lock<std::mutex> lock(pool.mux);
+			for (auto& list : pool.mapFree)
+			{
+				for (void* p : list.second) ::operator delete(p, std::align_val_t(nAlignment));
+				list.second.clear();
+			}
+			nFreed = pool.nCached;
+			pool.nCached = 0;
+		}
+		MemoryTracker::Release(MemoryTracker::PIXEL_CACHE, nFreed);
 	}
 
-	Pixel Sprite::Sample(const olc::vf2d& uv) const
+	size_t PixelPool::GetCachedBytes()
 	{
-		return Sample(uv.x, uv.y);
+		PixelPoolState& pool = GetPixelPool();
+		std::unique_lock<std::mutex> lock(pool.mux);
+		return pool.nCached;
 	}
 
-	Pixel Sprite::SampleBL(float u, float v) const
+	uint64_t PixelPool::GetAllocationCount()
+	{ return GetPixelPool().nAllocations.load(std::memory_order_relaxed); }
+
+	// Running totals sampled at the start and end of each frame. Uploads are counted on the
+	// update, render and job threads, and heap allocations can come from anywhere
+	static std::atomic<uint64_t> nTextureUploadBytes{ 0 };
+	static std::atomic<uint64_t> nHeapAllocations{ 0 };
+
+	// O------------------------------------------------------------------------------O
+	// | olc::Profiler IMPLEMENTATION                                                 |
+	// O------------------------------------------------------------------------------O
+	struct ProfilerState
 	{
-		u = u * width - 0.5f;
-		v = v * height - 0.5f;
-		int x = (int)floor(u); // cast to int rounds toward zero, not downward
-		int y = (int)floor(v); // Thanks @joshinils
-		float u_ratio = u - x;
-		float v_ratio = v - y;
-		float u_opposite = 1 - u_ratio;
-		float v_opposite = 1 - v_ratio;
+		// A slot is valid once nSeq holds its event index + 1, so the dump can skip
+		// slots that are mid-write or were overwritten by a later lap of the ring
+		struct Slot
+		{
+			std::atomic<uint64_t> nSeq{ 0 };
+			std::atomic<const char*> sName{ nullptr };
+			std::atomic<uint64_t> nStart{ 0 };
+			std::atomic<uint64_t> nEnd{ 0 };
+			std::atomic<uint32_t> nThread{ 0 };
+		};
 
-		olc::Pixel p1 = GetPixel(std::max(x, 0), std::max(y, 0));
-		olc::Pixel p2 = GetPixel(std::min(x + 1, (int)width - 1), std::max(y, 0));
-		olc::Pixel p3 = GetPixel(std::max(x, 0), std::min(y + 1, (int)height - 1));
-		olc::Pixel p4 = GetPixel(std::min(x + 1, (int)width - 1), std::min(y + 1, (int)height - 1));
+		static constexpr uint64_t nCapacity = 1 << 16;
+		std::unique_ptr<Slot[]> pSlots;
+		std::atomic<uint64_t> nHead{ 0 };
+		std::atomic<uint64_t> nFirst{ 0 };
+		std::atomic<uint32_t> nThreads{ 0 };
+		std::atomic<bool> bEnabled{ false };
+		std::mutex mux;
+	};
 
-		return olc::Pixel(
-			(uint8_t)((p1.r * u_opposite + p2.r * u_ratio) * v_opposite + (p3.r * u_opposite + p4.r * u_ratio) * v_ratio),
-			(uint8_t)((p1.g * u_opposite + p2.g * u_ratio) * v_opposite + (p3.g * u_opposite + p4.g * u_ratio) * v_ratio),
-			(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio));
+	// Never destroyed, zones may close on other threads during shutdown
+	static ProfilerState& GetProfiler()
+	{
+		static ProfilerState* prof = new ProfilerState;
+		return *prof;
 	}
 
-	Pixel Sprite::SampleBL(const olc::vf2d& uv) const
+	void Profiler::Enable(bool bEnable)
 	{
-		return SampleBL(uv.x, uv.y);
+		ProfilerState& prof = GetProfiler();
+		std::unique_lock<std::mutex> lock(prof.mux);
+		// The ring is only paid for once somebody wants a capture
+		if (bEnable && !prof.pSlots) prof.pSlots.reset(new ProfilerState::Slot[ProfilerState::nCapacity]);
+		prof.bEnabled.store(bEnable, std::memory_order_release);
 	}
 
-	Pixel* Sprite::GetData()
-	{ return pColData.data(); }
-
+	bool Profiler::IsEnabled()
+	{ return GetProfiler().bEnabled.load(std::memory_order_acquire); }
 
-	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	uint64_t Profiler::Now()
 	{
-		UNUSED(pack);
-		return loader->LoadImageResource(this, sImageFile, pack);
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
 	}
 
-	olc::Sprite* Sprite::Duplicate()
-	{
-		olc::Sprite* spr = new olc::Sprite(width, height);
-		std::memcpy(spr->GetData(), GetData(), width * height * sizeof(olc::Pixel));
-		spr->modeSample = modeSample;
-		return spr;
+	void Profiler::Record(const char* sName, uint64_t nStart, uint64_t nEnd)
+	{
+		ProfilerState& prof = GetProfiler();
+		if (!prof.bEnabled.load(std::memory_order_acquire)) return;
+		static thread_local uint32_t nThread = prof.nThreads.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		const uint64_t n = prof.nHead.fetch_add(1, std::memory_order_relaxed);
+		ProfilerState::Slot& s = prof.pSlots[n & (ProfilerState::nCapacity - 1)];
+		s.nSeq.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		s.sName.store(sName, std::memory_order_relaxed);
+		s.nStart.store(nStart, std::memory_order_relaxed);
+		s.nEnd.store(nEnd, std::memory_order_relaxed);
+		s.nThread.store(nThread, std::memory_order_relaxed);
+		s.nSeq.store(n + 1, std::memory_order_release);
 	}
 
-	olc::Sprite* Sprite::Duplicate(const olc::vi2d& vPos, const olc::vi2d& vSize)
+	void Profiler::Clear()
 	{
-		olc::Sprite* spr = new olc::Sprite(vSize.x, vSize.y);
-		for (int y = 0; y < vSize.y; y++)
-			for (int x = 0; x < vSize.x; x++)
-				spr->SetPixel(x, y, GetPixel(vPos.x + x, vPos.y + y));
-		return spr;
+		ProfilerState& prof = GetProfiler();
+		prof.nFirst.store(prof.nHead.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	}
 
-	olc::vi2d olc::Sprite::Size() const
+	bool Profiler::Dump(const std::string& sFile)
 	{
-		return { width, height };
+		ProfilerState& prof = GetProfiler();
+		std::ofstream ofs(sFile);
+		if (!ofs.is_open()) return false;
+
+		struct Event { const char* sName; uint64_t nStart, nEnd; uint32_t nThread; };
+		std::vector<Event> vEvents;
+		if (prof.pSlots)
+		{
+			const uint64_t nHead = prof.nHead.load(std::memory_order_acquire);
+			const uint64_t nFirst = std::max(prof.nFirst.load(std::memory_order_relaxed),
+				nHead > ProfilerState::nCapacity ? nHead - ProfilerState::nCapacity : uint64_t(0));
+			vEvents.reserve(size_t(nHead - std::min(nFirst, nHead)));
+			for (uint64_t n = nFirst; n < nHead; n++)
+			{
+				ProfilerState::Slot& s = prof.pSlots[n & (ProfilerState::nCapacity - 1)];
+				if (s.nSeq.load(std::memory_order_acquire) != n + 1) continue;
+				Event e{ s.sName.load(std::memory_order_relaxed), s.nStart.load(std::memory_order_relaxed),
+					s.nEnd.load(std::memory_order_relaxed), s.nThread.load(std::memory_order_relaxed) };
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (s.nSeq.load(std::memory_order_relaxed) != n + 1) continue;
+				vEvents.push_back(e);
+			}
+		}
+
+		// Timestamps are made relative to the capture so the viewer opens at zero
+		uint64_t nBase = UINT64_MAX;
+		for (auto& e : vEvents) nBase = std::min(nBase, e.nStart);
+
+		ofs << "{\"traceEvents\":[";
+		char buf[64];
+		for (size_t i = 0; i < vEvents.size(); i++)
+		{
+			const Event& e = vEvents[i];
+			ofs << (i ? ",\n" : "\n") << "{\"name\":\"";
+			for (const char* c = e.sName ? e.sName : "?"; *c; c++)
+			{
+				if (*c == '"' || *c == '\\') ofs << '\\' << *c;
+				else if (uint8_t(*c) < 0x20) ofs << ' ';
+				else ofs << *c;
+			}
+			snprintf(buf, sizeof(buf), "\",\"ph\":\"X\",\"ts\":%.3f", double(e.nStart - nBase) / 1000.0);
+			ofs << buf;
+			snprintf(buf, sizeof(buf), ",\"dur\":%.3f", double(e.nEnd - e.nStart) / 1000.0);
+			ofs << buf << ",\"pid\":1,\"tid\":" << e.nThread << "}";
+		}
+		ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return ofs.good();
 	}
 
 	// O------------------------------------------------------------------------------O
-	// | olc::Decal IMPLEMENTATION                                                    |
+	// | olc::MemoryTracker IMPLEMENTATION                                            |
 	// O------------------------------------------------------------------------------O
-	Decal::Decal(olc::Sprite* spr, bool filter, bool clamp)
+	struct MemoryTrackerState
 	{
-		id = -1;
-		if (spr == nullptr) return;
-		sprite = spr;
-		id = renderer->CreateTexture(sprite->width, sprite->height, filter, clamp);
-		Update();
-	}
+		// Counters are signed so a release seen before its allocation cannot wrap
+		struct Counter
+		{
+			std::atomic<int64_t> nCurrent{ 0 };
+			std::atomic<int64_t> nPeak{ 0 };
+			std::atomic<size_t> nBudget{ 0 };
+			std::atomic<bool> bOverBudget{ false };
+		};
 
-	Decal::Decal(const uint32_t nExistingTextureResource, olc::Sprite* spr)
+		std::array<Counter, MemoryTracker::nMaxTags> vCounters;
+		std::vector<std::string> vNames = { "Pixels", "Pixel Cache", "Textures", "Decal Queues", "Resource Packs" };
+		std::function<void(const std::string&)> funcWarning;
+		std::mutex mux;
+	};
+
+	// Never destroyed, sprites and buffers with static lifetime report after main() returns
+	static MemoryTrackerState& GetMemoryTracker()
 	{
-		if (spr == nullptr) return;
-		id = nExistingTextureResource;
+		static MemoryTrackerState* tracker = new MemoryTrackerState;
+		return *tracker;
 	}
 
-	void Decal::Update()
+	static std::string FormatBytes(int64_t nBytes)
 	{
-		if (sprite == nullptr) return;
-		vUVScale = { 1.0f / float(sprite->width), 1.0f / float(sprite->height) };
-		renderer->ApplyTexture(id);
-		renderer->UpdateTexture(id, sprite);
+		char buf[32];
+		if (nBytes >= 1024 * 1024) snprintf(buf, sizeof(buf), "%.2f MB", double(nBytes) / (1024.0 * 1024.0));
+		else if (nBytes >= 1024) snprintf(buf, sizeof(buf), "%.2f KB", double(nBytes) / 1024.0);
+		else snprintf(buf, sizeof(buf), "%lld B", (long long)nBytes);
+		return buf;
 	}
 
-	void Decal::UpdateSprite()
+	static void MemoryTrackerUpdated(uint32_t nTag, int64_t nCurrent)
 	{
-		if (sprite == nullptr) return;
-		renderer->ApplyTexture(id);
-		renderer->ReadTexture(id, sprite);
+		MemoryTrackerState& tracker = GetMemoryTracker();
+		MemoryTrackerState::Counter& c = tracker.vCounters[nTag];
+
+		int64_t nPeak = c.nPeak.load(std::memory_order_relaxed);
+		while (nCurrent > nPeak && !c.nPeak.compare_exchange_weak(nPeak, nCurrent, std::memory_order_relaxed));
+
+		const size_t nBudget = c.nBudget.load(std::memory_order_relaxed);
+		if (nBudget == 0) return;
+		if (nCurrent <= int64_t(nBudget))
+		{
+			c.bOverBudget.store(false, std::memory_order_relaxed);
+			return;
+		}
+		if (c.bOverBudget.exchange(true, std::memory_order_relaxed)) return;
+
+		std::function<void(const std::string&)> handler;
+		std::string sWarning;
+		{
+			std::unique_lock<std::mutex> lock(tracker.mux);
+			handler = tracker.funcWarning;
+			sWarning = "Memory budget exceeded: " + tracker.vNames[nTag] + " is using " + FormatBytes(nCurrent) + " of " + FormatBytes(int64_t(nBudget));
+		}
+		if (handler) handler(sWarning);
+		else std::cerr << sWarning << "\n";
 	}
 
-	Decal::~Decal()
+	uint32_t MemoryTracker::RegisterTag(const std::string& sName, size_t nBudgetBytes)
 	{
-		if (id != -1)
+		MemoryTrackerState& tracker = GetMemoryTracker();
+		uint32_t nTag = 0;
 		{
-			renderer->DeleteTexture(id);
-			id = -1;
+			std::unique_lock<std::mutex> lock(tracker.mux);
+			auto it = std::find(tracker.vNames.begin(), tracker.vNames.end(), sName);
+			if (it != tracker.vNames.end()) return uint32_t(it - tracker.vNames.begin());
+			// Out of tags, share the last one rather than fail
+			if (tracker.vNames.size() == nMaxTags) return nMaxTags - 1;
+			nTag = uint32_t(tracker.vNames.size());
+			tracker.vNames.push_back(sName);
 		}
+		SetBudget(nTag, nBudgetBytes);
+		return nTag;
 	}
 
-	void Renderable::Create(uint32_t width, uint32_t height, bool filter, bool clamp)
+	void MemoryTracker::Allocate(uint32_t nTag, size_t nBytes)
+	{
+		if (nTag >= nMaxTags || nBytes == 0) return;
+		const int64_t nCurrent = GetMemoryTracker().vCounters[nTag].nCurrent.fetch_add(int64_t(nBytes), std::memory_order_relaxed) + int64_t(nBytes);
+		MemoryTrackerUpdated(nTag, nCurrent);
+	}
+
+	void MemoryTracker::Release(uint32_t nTag, size_t nBytes)
+	{
+		if (nTag >= nMaxTags || nBytes == 0) return;
+		MemoryTrackerState::Counter& c = GetMemoryTracker().vCounters[nTag];
+		const int64_t nCurrent = c.nCurrent.fetch_sub(int64_t(nBytes), std::memory_order_relaxed) - int64_t(nBytes);
+		if (nCurrent <= int64_t(c.nBudget.load(std::memory_order_relaxed))) c.bOverBudget.store(false, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::Set(uint32_t nTag, size_t nBytes)
+	{
+		if (nTag >= nMaxTags) return;
+		GetMemoryTracker().vCounters[nTag].nCurrent.store(int64_t(nBytes), std::memory_order_relaxed);
+		MemoryTrackerUpdated(nTag, int64_t(nBytes));
+	}
+
+	void MemoryTracker::SetBudget(uint32_t nTag, size_t nBytes)
+	{
+		if (nTag >= nMaxTags) return;
+		MemoryTrackerState::Counter& c = GetMemoryTracker().vCounters[nTag];
+		c.nBudget.store(nBytes, std::memory_order_relaxed);
+		c.bOverBudget.store(false, std::memory_order_relaxed);
+		MemoryTrackerUpdated(nTag, c.nCurrent.load(std::memory_order_relaxed));
+	}
+
+	void MemoryTracker::SetWarningHandler(std::function<void(const std::string&)> handler)
+	{
+		MemoryTrackerState& tracker = GetMemoryTracker();
+		std::unique_lock<std::mutex> lock(tracker.mux);
+		tracker.funcWarning = handler;
+	}
+
+	size_t MemoryTracker::GetCurrent(uint32_t nTag)
+	{
+		if (nTag >= nMaxTags) return 0;
+		return size_t(std::max<int64_t>(0, GetMemoryTracker().vCounters[nTag].nCurrent.load(std::memory_order_relaxed)));
+	}
+
+	size_t MemoryTracker::GetPeak(uint32_t nTag)
+	{
+		if (nTag >= nMaxTags) return 0;
+		return size_t(GetMemoryTracker().vCounters[nTag].nPeak.load(std::memory_order_relaxed));
+	}
+
+	void MemoryTracker::Dump(std::ostream& os)
+	{
+		MemoryTrackerState& tracker = GetMemoryTracker();
+		std::vector<std::string> vNames;
+		{
+			std::unique_lock<std::mutex> lock(tracker.mux);
+			vNames = tracker.vNames;
+		}
+
+		char buf[128];
+		snprintf(buf, sizeof(buf), "%-20s %12s %12s %12s\n", "Tag", "Current", "Peak", "Budget");
+		os << buf;
+		int64_t nTotal = 0, nTotalPeak = 0;
+		for (uint32_t i = 0; i < uint32_t(vNames.size()); i++)
+		{
+			const int64_t nCurrent = int64_t(GetCurrent(i));
+			const int64_t nPeak = int64_t(GetPeak(i));
+			const size_t nBudget = tracker.vCounters[i].nBudget.load(std::memory_order_relaxed);
+			snprintf(buf, sizeof(buf), "%-20s %12s %12s %12s%s\n", vNames[i].c_str(), FormatBytes(nCurrent).c_str(), FormatBytes(nPeak).c_str(),
+				nBudget ? FormatBytes(int64_t(nBudget)).c_str() : "-", nBudget && nCurrent > int64_t(nBudget) ? " OVER" : "");
+			os << buf;
+			nTotal += nCurrent;
+			nTotalPeak += nPeak;
+		}
+		// Tags peak at different times, so the sum of peaks is an upper bound
+		snprintf(buf, sizeof(buf), "%-20s %12s %12s\n", "Total", FormatBytes(nTotal).c_str(), FormatBytes(nTotalPeak).c_str());
+		os << buf;
+	}
+
+	bool MemoryTracker::Dump(const std::string& sFile)
+	{
+		std::ofstream ofs(sFile);
+		if (!ofs.is_open()) return false;
+		Dump(ofs);
+		return ofs.good();
+	}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::LatencyTracker IMPLEMENTATION                                           |
+	// O------------------------------------------------------------------------------O
+	struct LatencyTrackerState
+	{
+		// Newest samples in milliseconds, as a ring once full
+		struct Series
+		{
+			std::string sName;
+			std::vector<float> vTotal;
+			std::vector<float> vUpdate;
+			size_t nNext = 0;
+			uint64_t nCount = 0;
+		};
+
+		static constexpr size_t nCapacity = 1 << 16;
+		std::atomic<bool> bEnabled{ false };
+		std::mutex mux;
+		// Input time and the time it was marked, waiting for their frame to be submitted
+		std::vector<std::pair<const char*, std::array<uint64_t, 2>>> vPending;
+		std::vector<Series> vSeries;
+
+		Series* Find(const std::string& sName)
+		{
+			for (auto& series : vSeries) if (series.sName == sName) return &series;
+			return nullptr;
+		}
+	};
+
+	// Never destroyed, frames may still be displayed on other threads during shutdown
+	static LatencyTrackerState& GetLatencyTracker()
+	{
+		static LatencyTrackerState* lat = new LatencyTrackerState;
+		return *lat;
+	}
+
+	// Called by the engine once the frame carrying these marks has been displayed
+	static void RecordLatencies(std::vector<std::pair<const char*, std::array<uint64_t, 2>>>& vMarks)
+	{
+		if (vMarks.empty()) return;
+		const uint64_t nDisplayed = Profiler::Now();
+		LatencyTrackerState& lat = GetLatencyTracker();
+		std::unique_lock<std::mutex> lock(lat.mux);
+		for (const auto& mark : vMarks)
+		{
+			LatencyTrackerState::Series* series = lat.Find(mark.first);
+			if (series == nullptr)
+			{
+				lat.vSeries.emplace_back();
+				series = &lat.vSeries.back();
+				series->sName = mark.first;
+			}
+
+			const float fTotal = float(double(nDisplayed - mark.second[0]) / 1e6);
+			const float fUpdate = float(double(mark.second[1] - mark.second[0]) / 1e6);
+			if (series->vTotal.size() < LatencyTrackerState::nCapacity)
+			{
+				series->vTotal.push_back(fTotal);
+				series->vUpdate.push_back(fUpdate);
+			}
+			else
+			{
+				series->vTotal[series->nNext] = fTotal;
+				series->vUpdate[series->nNext] = fUpdate;
+			}
+			series->nNext = (series->nNext + 1) % LatencyTrackerState::nCapacity;
+			series->nCount++;
+		}
+		vMarks.clear();
+	}
+
+	static float LatencyPercentile(std::vector<float> vSamples, float fPercentile)
+	{
+		if (vSamples.empty()) return 0.0f;
+		const size_t n = std::min(vSamples.size() - 1, size_t(std::max(fPercentile, 0.0f) * float(vSamples.size())));
+		std::nth_element(vSamples.begin(), vSamples.begin() + n, vSamples.end());
+		return vSamples[n];
+	}
+
+	void LatencyTracker::Enable(bool bEnable)
+	{ GetLatencyTracker().bEnabled.store(bEnable, std::memory_order_release); }
+
+	bool LatencyTracker::IsEnabled()
+	{ return GetLatencyTracker().bEnabled.load(std::memory_order_acquire); }
+
+	void LatencyTracker::MarkResponse(uint64_t nInputTime, const char* sName)
+	{
+		LatencyTrackerState& lat = GetLatencyTracker();
+		if (!lat.bEnabled.load(std::memory_order_acquire)) return;
+		std::unique_lock<std::mutex> lock(lat.mux);
+		lat.vPending.push_back({ sName, { nInputTime, Profiler::Now() } });
+	}
+
+	float LatencyTracker::GetPercentile(const std::string& sName, float fPercentile)
+	{
+		LatencyTrackerState& lat = GetLatencyTracker();
+		std::unique_lock<std::mutex> lock(lat.mux);
+		LatencyTrackerState::Series* series = lat.Find(sName);
+		return series ? LatencyPercentile(series->vTotal, fPercentile) : 0.0f;
+	}
+
+	void LatencyTracker::Clear()
+	{
+		LatencyTrackerState& lat = GetLatencyTracker();
+		std::unique_lock<std::mutex> lock(lat.mux);
+		lat.vPending.clear();
+		lat.vSeries.clear();
+	}
+
+	void LatencyTracker::Dump(std::ostream& os)
+	{
+		LatencyTrackerState& lat = GetLatencyTracker();
+		std::unique_lock<std::mutex> lock(lat.mux);
+
+		// Headless builds have nothing to present, so only the engine's share is measured
+#if defined(OLC_PLATFORM_HEADLESS)
+		os << "Input to DisplayFrame() latency in ms (headless, engine only)\n";
+#else
+		os << "Input to DisplayFrame() latency in ms, before any compositor or display delay\n";
+#endif
+		// "To update" is how long inputs waited for the update that responded to them
+		char buf[128];
+		snprintf(buf, sizeof(buf), "%-20s %8s %8s %8s %8s %8s %10s\n", "Name", "Count", "p50", "p90", "p99", "Max", "To update");
+		os << buf;
+		for (const auto& series : lat.vSeries)
+		{
+			snprintf(buf, sizeof(buf), "%-20s %8llu %8.2f %8.2f %8.2f %8.2f %10.2f\n", series.sName.c_str(), (unsigned long long)series.nCount,
+				LatencyPercentile(series.vTotal, 0.5f), LatencyPercentile(series.vTotal, 0.9f), LatencyPercentile(series.vTotal, 0.99f),
+				LatencyPercentile(series.vTotal, 1.0f), LatencyPercentile(series.vUpdate, 0.5f));
+			os << buf;
+		}
+
+		// Buckets roughly follow frame boundaries at 60Hz
+		static const float fEdges[] = { 4.0f, 8.0f, 16.7f, 33.3f, 50.0f, 66.7f, 100.0f, 200.0f };
+		constexpr size_t nBuckets = sizeof(fEdges) / sizeof(fEdges[0]) + 1;
+		for (const auto& series : lat.vSeries)
+		{
+			os << "\n" << series.sName << "\n";
+			std::array<size_t, nBuckets> vCounts{};
+			for (float f : series.vTotal)
+				vCounts[std::upper_bound(std::begin(fEdges), std::end(fEdges), f) - std::begin(fEdges)]++;
+			const size_t nMost = std::max<size_t>(1, *std::max_element(vCounts.begin(), vCounts.end()));
+			for (size_t i = 0; i < nBuckets; i++)
+			{
+				if (i < nBuckets - 1) snprintf(buf, sizeof(buf), "  < %6.1f ", fEdges[i]);
+				else snprintf(buf, sizeof(buf), "  >=%6.1f ", fEdges[nBuckets - 2]);
+				os << buf << std::string(40 * vCounts[i] / nMost, '#') << " " << vCounts[i] << "\n";
+			}
+		}
+	}
+
+	bool LatencyTracker::Dump(const std::string& sFile)
+	{
+		std::ofstream ofs(sFile);
+		if (!ofs.is_open()) return false;
+		Dump(ofs);
+		return ofs.good();
+	}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::JobSystem IMPLEMENTATION                                                |
+	// O------------------------------------------------------------------------------O
+	struct Job
+	{
+		std::function<void()> func;
+		// Unfinished dependencies, plus one held by Schedule() until they are all wired up
+		std::atomic<uint32_t> nPending{ 1 };
+		std::atomic<bool> bDone{ false };
+		std::mutex mux;
+		std::vector<olc::JobHandle> vDependents;
+		// The buffer recording on the scheduling thread, see DecalRecordingPause
+		olc::DecalCommandBuffer* pRecording = nullptr;
+	};
+
+	// The owner pushes and pops at the back, thieves take from the front
+	struct JobQueue
+	{
+		std::mutex mux;
+		std::deque<olc::JobHandle> q;
+	};
+
+	// Lets a thread find its own queue, workers are only ever in one system
+	static thread_local const olc::JobSystem* pJobSystemOwner = nullptr;
+	static thread_local uint32_t nJobSystemWorker = 0;
+
+	// The buffer recording on this thread, if any, see DecalCommandBuffer::Begin()
+	static thread_local olc::DecalCommandBuffer* pDecalRecording = nullptr;
+
+	// A thread that helps with other jobs while it waits may pick up work that is not its
+	// own. That work must not be recorded into the buffer the thread has open, and its own
+	// Begin()/End() must not disturb it. Jobs scheduled under the same recording, like the
+	// helpers of a ParallelFor() made while recording, run as part of it
+	struct DecalRecordingPause
+	{
+		olc::DecalCommandBuffer* pSaved = pDecalRecording;
+		explicit DecalRecordingPause(const olc::Job& job) { if (job.pRecording != pSaved) pDecalRecording = nullptr; }
+		~DecalRecordingPause() { pDecalRecording = pSaved; }
+	};
+
+	JobSystem::~JobSystem()
+	{ Stop(); }
+
+	void JobSystem::Start(uint32_t nWorkers)
+	{
+		std::unique_lock<std::mutex> lock(muxStart);
+		if (bRunning) return;
+
+		// Without threads, as on the web, jobs only run when they are waited on
+#if !defined(OLC_PLATFORM_EMSCRIPTEN)
+		if (nWorkers == 0)
+		{
+			const uint32_t nThreads = std::thread::hardware_concurrency();
+			// One at least, so scheduled jobs make progress without anyone waiting on them
+			nWorkers = nThreads > 2 ? nThreads - 1 : 1;
+		}
+#else
+		nWorkers = 0;
+#endif
+
+		vQueues.clear();
+		for (uint32_t i = 0; i <= nWorkers; i++) vQueues.push_back(std::make_unique<olc::JobQueue>());
+		bQuit = false;
+		bRunning = true;
+		for (uint32_t i = 0; i < nWorkers; i++)
+			vWorkers.emplace_back(&JobSystem::WorkerThread, this, i);
+	}
+
+	void JobSystem::Stop()
+	{
+		std::unique_lock<std::mutex> lock(muxStart);
+		if (!bRunning) return;
+
+		{
+			std::unique_lock<std::mutex> sleep(muxSleep);
+			bQuit = true;
+		}
+		cvSleep.notify_all();
+		for (auto& t : vWorkers) t.join();
+		vWorkers.clear();
+
+		// Whatever is left had no worker to run it
+		while (RunOne(QueueIndex()));
+		vQueues.clear();
+		bRunning = false;
+	}
+
+	uint32_t JobSystem::GetWorkerCount() const
+	{ return uint32_t(vWorkers.size()); }
+
+	olc::JobHandle JobSystem::Schedule(std::function<void()> func, const std::vector<olc::JobHandle>& vDependencies)
+	{
+		if (!bRunning) Start();
+
+		olc::JobHandle job = std::make_shared<olc::Job>();
+		job->func = std::move(func);
+		job->pRecording = pDecalRecording;
+		for (const auto& dep : vDependencies)
+		{
+			if (!dep) continue;
+			std::unique_lock<std::mutex> lock(dep->mux);
+			if (dep->bDone) continue;
+			job->nPending++;
+			dep->vDependents.push_back(job);
+		}
+
+		if (--job->nPending == 0) Push(job);
+		return job;
+	}
+
+	void JobSystem::Wait(const olc::JobHandle& job)
+	{
+		// A job that was dropped by Stop() will never finish
+		if (!job || !bRunning) return;
+		const uint32_t nQueue = QueueIndex();
+		while (!job->bDone)
+		{
+			if (RunOne(nQueue)) continue;
+
+			// Nothing to help with, sleep until something is queued or the job is done
+			std::unique_lock<std::mutex> lock(muxSleep);
+			nSleeping++;
+			cvSleep.wait(lock, [&] { return job->bDone || nQueued > 0; });
+			nSleeping--;
+		}
+	}
+
+	bool JobSystem::IsDone(const olc::JobHandle& job)
+	{ return !job || job->bDone; }
+
+	void JobSystem::ParallelFor(uint32_t nBegin, uint32_t nEnd, uint32_t nGrain, const std::function<void(uint32_t, uint32_t)>& func)
+	{
+		if (nEnd <= nBegin) return;
+		nGrain = std::max(nGrain, 1u);
+		const uint32_t nRanges = uint32_t((uint64_t(nEnd - nBegin) + nGrain - 1) / nGrain);
+
+		// Ranges are claimed from a shared counter, so whoever is free takes the next one
+		std::atomic<uint32_t> nNext{ 0 };
+		auto body = [&]()
+		{
+			for (uint32_t n = nNext++; n < nRanges; n = nNext++)
+			{
+				const uint32_t nFirst = nBegin + n * nGrain;
+				func(nFirst, nFirst + std::min(nGrain, nEnd - nFirst));
+			}
+		};
+
+		// With one core the helpers would only take turns with the caller
+		static const uint32_t nThreads = std::thread::hardware_concurrency();
+		if (nRanges < 2 || nThreads < 2)
+		{
+			body();
+			return;
+		}
+
+		if (!bRunning) Start();
+		std::vector<olc::JobHandle> vHelpers;
+		const uint32_t nHelpers = std::min(GetWorkerCount(), nRanges - 1);
+		for (uint32_t i = 0; i < nHelpers; i++) vHelpers.push_back(Schedule(body));
+		body();
+
+		// Helpers that start late find nothing left, but body must outlive them
+		for (auto& job : vHelpers) Wait(job);
+	}
+
+	void JobSystem::WorkerThread(uint32_t nIndex)
+	{
+		pJobSystemOwner = this;
+		nJobSystemWorker = nIndex;
+
+		while (true)
+		{
+			if (RunOne(nIndex)) continue;
+
+			std::unique_lock<std::mutex> lock(muxSleep);
+			if (bQuit && nQueued == 0) break;
+			nSleeping++;
+			cvSleep.wait(lock, [&] { return bQuit || nQueued > 0; });
+			nSleeping--;
+		}
+
+		pJobSystemOwner = nullptr;
+	}
+
+	uint32_t JobSystem::QueueIndex() const
+	{ return pJobSystemOwner == this ? nJobSystemWorker : uint32_t(vQueues.size() - 1); }
+
+	bool JobSystem::RunOne(uint32_t nQueue)
+	{
+		olc::JobHandle job;
+		{
+			olc::JobQueue& own = *vQueues[nQueue];
+			std::unique_lock<std::mutex> lock(own.mux);
+			if (!own.q.empty()) { job = std::move(own.q.back()); own.q.pop_back(); }
+		}
+
+		// Steal the oldest job from someone else, starting with our neighbour
+		for (size_t i = 1; !job && i < vQueues.size(); i++)
+		{
+			olc::JobQueue& other = *vQueues[(nQueue + i) % vQueues.size()];
+			std::unique_lock<std::mutex> lock(other.mux);
+			if (!other.q.empty()) { job = std::move(other.q.front()); other.q.pop_front(); }
+		}
+
+		if (!job) return false;
+		nQueued--;
+		{
+			DecalRecordingPause pause(*job);
+			job->func();
+		}
+		Finish(*job);
+		return true;
+	}
+
+	void JobSystem::Push(olc::JobHandle job)
+	{
+		olc::JobQueue& queue = *vQueues[QueueIndex()];
+		{
+			std::unique_lock<std::mutex> lock(queue.mux);
+			queue.q.push_back(std::move(job));
+		}
+		nQueued++;
+		Wake();
+	}
+
+	void JobSystem::Finish(olc::Job& job)
+	{
+		// Captures are released now rather than when the last handle goes
+		job.func = nullptr;
+
+		std::vector<olc::JobHandle> vReady;
+		{
+			std::unique_lock<std::mutex> lock(job.mux);
+			job.bDone = true;
+			vReady.swap(job.vDependents);
+		}
+
+		for (auto& dep : vReady)
+			if (--dep->nPending == 0) Push(std::move(dep));
+
+		// Someone may be sleeping in Wait() on this job
+		Wake();
+	}
+
+	void JobSystem::Wake()
+	{
+		// Sleepers count themselves before checking for work, so if none are
+		// counted here any that are about to sleep will see the new state
+		if (nSleeping == 0) return;
+		{ std::unique_lock<std::mutex> lock(muxSleep); }
+		cvSleep.notify_all();
+	}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::Sprite IMPLEMENTATION                                                   |
+	// O------------------------------------------------------------------------------O
+	Sprite::Sprite()
+	{ width = 0; height = 0; }
+
+	Sprite::Sprite(const std::string& sImageFile, olc::ResourcePack* pack)
+	{ LoadFromFile(sImageFile, pack); }
+
+	Sprite::Sprite(int32_t w, int32_t h)
+	{		
+		width = w;		height = h;
+		pColData.assign(size_t(width) * size_t(height), nDefaultPixel);
+	}
+
+	Sprite::~Sprite()
+	{ pColData.clear();	}
+
+	olc::Sprite& Sprite::operator=(const olc::Sprite& spr)
+	{
+		if (&spr == this) return *this;
+		width = spr.width;
+		height = spr.height;
+		pColData = spr.pColData;
+		modeSample = spr.modeSample;
+		vMips.clear();
+		for (const auto& mip : spr.vMips)
+		{
+			vMips.push_back(std::make_unique<olc::Sprite>());
+			*vMips.back() = *mip;
+		}
+		return *this;
+	}
+
+	void Sprite::SetSampleMode(olc::Sprite::Mode mode)
+	{
+		modeSample = mode;
+		for (auto& mip : vMips) mip->modeSample = mode;
+	}
+
+	Pixel Sprite::GetPixel(const olc::vi2d& a) const
+	{ return GetPixel(a.x, a.y); }
+
+	bool Sprite::SetPixel(const olc::vi2d& a, Pixel p)
+	{ return SetPixel(a.x, a.y, p); }
+
+	Pixel Sprite::GetPixel(int32_t x, int32_t y) const
+	{
+		// GPU only sprites keep their size but not their pixels
+		if (pColData.empty()) return Pixel(0, 0, 0, 0);
+
+		if (modeSample == olc::Sprite::Mode::NORMAL)
+		{
+			if (x >= 0 && x < width && y >= 0 && y < height)
+				return pColData[y * width + x];
+			else
+				return Pixel(0, 0, 0, 0);
+		}
+		else
+		{
+			if (modeSample == olc::Sprite::Mode::PERIODIC)
+				return pColData[abs(y % height) * width + abs(x % width)];
+			else
+				return pColData[std::max(0, std::min(y, height-1)) * width + std::max(0, std::min(x, width-1))];
+		}
+	}
+
+	bool Sprite::SetPixel(int32_t x, int32_t y, Pixel p)
+	{
+		if (x >= 0 && x < width && y >= 0 && y < height && !pColData.empty())
+		{
+			pColData[y * width + x] = p;
+			return true;
+		}
+		else
+			return false;
+	}
+
+	Pixel Sprite::Sample(float x, float y) const
+	{
+		int32_t sx = std::min((int32_t)((x * (float)width)), width - 1);
+		int32_t sy = std::min((int32_t)((y * (float)height)), height - 1);
+		return GetPixel(sx, sy);
+	}
+
+	Pixel Sprite::Sample(const olc::vf2d& uv) const
+	{
+		return Sample(uv.x, uv.y);
+	}
+
+	Pixel Sprite::SampleBL(float u, float v) const
+	{
+		u = u * width - 0.5f;
+		v = v * height - 0.5f;
+		int x = (int)floor(u); // cast to int rounds toward zero, not downward
+		int y = (int)floor(v); // Thanks @joshinils
+		float u_ratio = u - x;
+		float v_ratio = v - y;
+		float u_opposite = 1 - u_ratio;
+		float v_opposite = 1 - v_ratio;
+
+		olc::Pixel p1 = GetPixel(std::max(x, 0), std::max(y, 0));
+		olc::Pixel p2 = GetPixel(std::min(x + 1, (int)width - 1), std::max(y, 0));
+		olc::Pixel p3 = GetPixel(std::max(x, 0), std::min(y + 1, (int)height - 1));
+		olc::Pixel p4 = GetPixel(std::min(x + 1, (int)width - 1), std::min(y + 1, (int)height - 1));
+
+		return olc::Pixel(
+			(uint8_t)((p1.r * u_opposite + p2.r * u_ratio) * v_opposite + (p3.r * u_opposite + p4.r * u_ratio) * v_ratio),
+			(uint8_t)((p1.g * u_opposite + p2.g * u_ratio) * v_opposite + (p3.g * u_opposite + p4.g * u_ratio) * v_ratio),
+			(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio),
+			(uint8_t)((p1.a * u_opposite + p2.a * u_ratio) * v_opposite + (p3.a * u_opposite + p4.a * u_ratio) * v_ratio));
+	}
+
+	Pixel Sprite::SampleBL(const olc::vf2d& uv) const
+	{
+		return SampleBL(uv.x, uv.y);
+	}
+
+	template<olc::Sprite::Mode mode>
+	Pixel Sprite::Fetch(int32_t x, int32_t y) const
+	{
+		// GetPixel() with the sample mode known up front
+		if constexpr (mode == olc::Sprite::Mode::NORMAL)
+			return (uint32_t(x) < uint32_t(width) && uint32_t(y) < uint32_t(height)) ? pColData[y * width + x] : Pixel(0, 0, 0, 0);
+		else if constexpr (mode == olc::Sprite::Mode::PERIODIC)
+			return pColData[abs(y % height) * width + abs(x % width)];
+		else
+			return pColData[std::max(0, std::min(y, height - 1)) * width + std::max(0, std::min(x, width - 1))];
+	}
+
+	template<olc::Sprite::Filter filter, olc::Sprite::Mode mode>
+	void Sprite::SampleSpan(const float* pU, const float* pV, Pixel* pOut, int32_t nCount) const
+	{
+		if constexpr (filter == olc::Sprite::Filter::NEAREST)
+		{
+			for (int32_t i = 0; i < nCount; i++)
+			{
+				const int32_t sx = std::min((int32_t)((pU[i] * (float)width)), width - 1);
+				const int32_t sy = std::min((int32_t)((pV[i] * (float)height)), height - 1);
+				pOut[i] = Fetch<mode>(sx, sy);
+			}
+		}
+		else
+		{
+#if defined(OLC_SSE2)
+			const __m128i mZero = _mm_setzero_si128();
+			auto expand = [&](Pixel p) { return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(p.n)), mZero), mZero)); };
+#endif
+			for (int32_t i = 0; i < nCount; i++)
+			{
+				// Same arithmetic as SampleBL(), so results match it exactly
+				const float u = pU[i] * width - 0.5f;
+				const float v = pV[i] * height - 0.5f;
+				const int x = (int)floor(u);
+				const int y = (int)floor(v);
+				const float u_ratio = u - x;
+				const float v_ratio = v - y;
+				const float u_opposite = 1 - u_ratio;
+				const float v_opposite = 1 - v_ratio;
+
+				const Pixel p1 = Fetch<mode>(std::max(x, 0), std::max(y, 0));
+				const Pixel p2 = Fetch<mode>(std::min(x + 1, width - 1), std::max(y, 0));
+				const Pixel p3 = Fetch<mode>(std::max(x, 0), std::min(y + 1, height - 1));
+				const Pixel p4 = Fetch<mode>(std::min(x + 1, width - 1), std::min(y + 1, height - 1));
+
+#if defined(OLC_SSE2)
+				// All four channels in one register
+				const __m128 uo = _mm_set1_ps(u_opposite), ur = _mm_set1_ps(u_ratio);
+				const __m128 top = _mm_add_ps(_mm_mul_ps(expand(p1), uo), _mm_mul_ps(expand(p2), ur));
+				const __m128 bot = _mm_add_ps(_mm_mul_ps(expand(p3), uo), _mm_mul_ps(expand(p4), ur));
+				const __m128i c = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(top, _mm_set1_ps(v_opposite)), _mm_mul_ps(bot, _mm_set1_ps(v_ratio))));
+				const __m128i c16 = _mm_packs_epi32(c, c);
+				pOut[i].n = uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(c16, c16)));
+#else
+				pOut[i] = olc::Pixel(
+					(uint8_t)((p1.r * u_opposite + p2.r * u_ratio) * v_opposite + (p3.r * u_opposite + p4.r * u_ratio) * v_ratio),
+					(uint8_t)((p1.g * u_opposite + p2.g * u_ratio) * v_opposite + (p3.g * u_opposite + p4.g * u_ratio) * v_ratio),
+					(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio),
+					(uint8_t)((p1.a * u_opposite + p2.a * u_ratio) * v_opposite + (p3.a * u_opposite + p4.a * u_ratio) * v_ratio));
+#endif
+			}
+		}
+	}
+
+	void Sprite::SampleSpan(const float* pU, const float* pV, Pixel* pOut, int32_t nCount, olc::Sprite::Filter filter) const
+	{
+		if (pColData.empty()) { std::fill_n(pOut, nCount, Pixel(0, 0, 0, 0)); return; }
+
+		if (filter == olc::Sprite::Filter::NEAREST)
+		{
+			switch (modeSample)
+			{
+			case olc::Sprite::Mode::NORMAL: SampleSpan<olc::Sprite::Filter::NEAREST, olc::Sprite::Mode::NORMAL>(pU, pV, pOut, nCount); break;
+			case olc::Sprite::Mode::PERIODIC: SampleSpan<olc::Sprite::Filter::NEAREST, olc::Sprite::Mode::PERIODIC>(pU, pV, pOut, nCount); break;
+			case olc::Sprite::Mode::CLAMP: SampleSpan<olc::Sprite::Filter::NEAREST, olc::Sprite::Mode::CLAMP>(pU, pV, pOut, nCount); break;
+			}
+		}
+		else
+		{
+			switch (modeSample)
+			{
+			case olc::Sprite::Mode::NORMAL: SampleSpan<olc::Sprite::Filter::BILINEAR, olc::Sprite::Mode::NORMAL>(pU, pV, pOut, nCount); break;
+			case olc::Sprite::Mode::PERIODIC: SampleSpan<olc::Sprite::Filter::BILINEAR, olc::Sprite::Mode::PERIODIC>(pU, pV, pOut, nCount); break;
+			case olc::Sprite::Mode::CLAMP: SampleSpan<olc::Sprite::Filter::BILINEAR, olc::Sprite::Mode::CLAMP>(pU, pV, pOut, nCount); break;
+			}
+		}
+	}
+
+	Pixel* Sprite::GetData()
+	{
+		return pColData.data();
+	}
+
+
+	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	{
+		UNUSED(pack);
+		return loader->LoadImageResource(this, sImageFile, pack);
+	}
+
+	olc::Sprite* Sprite::Duplicate()
+	{
+		olc::Sprite* spr = new olc::Sprite(width, height);
+		if (!pColData.empty()) std::memcpy(spr->GetData(), pColData.data(), width * height * sizeof(olc::Pixel));
+		spr->modeSample = modeSample;
+		return spr;
+	}
+
+	olc::Sprite* Sprite::Duplicate(const olc::vi2d& vPos, const olc::vi2d& vSize)
+	{
+		olc::Sprite* spr = new olc::Sprite(vSize.x, vSize.y);
+		for (int y = 0; y < vSize.y; y++)
+		{
+			// Rows wholly inside the sprite are copied as they are, the sample mode decides the rest
+			const int sy = vPos.y + y;
+			if (sy >= 0 && sy < height && vPos.x >= 0 && vPos.x + vSize.x <= width && !pColData.empty())
+				std::memcpy((void*)(spr->pColData.data() + size_t(y) * vSize.x), pColData.data() + size_t(sy) * width + vPos.x, size_t(vSize.x) * sizeof(olc::Pixel));
+			else
+				for (int x = 0; x < vSize.x; x++)
+					spr->SetPixel(x, y, GetPixel(vPos.x + x, sy));
+		}
+		return spr;
+	}
+
+	olc::vi2d olc::Sprite::Size() const
+	{
+		return { width, height };
+	}
+
+	void Sprite::GenerateMips()
+	{
+		vMips.clear();
+		const olc::Sprite* src = this;
+		while ((src->width > 1 || src->height > 1) && !src->pColData.empty())
+		{
+			auto mip = std::make_unique<olc::Sprite>(std::max(src->width / 2, 1), std::max(src->height / 2, 1));
+			mip->modeSample = modeSample;
+
+			// Each texel is the mean of the 2x2 block above it, the last row and column
+			// repeat where the level above has odd dimensions
+			for (int32_t y = 0; y < mip->height; y++)
+			{
+				const olc::Pixel* pRowA = src->pColData.data() + size_t(std::min(y * 2, src->height - 1)) * src->width;
+				const olc::Pixel* pRowB = src->pColData.data() + size_t(std::min(y * 2 + 1, src->height - 1)) * src->width;
+				olc::Pixel* pOut = mip->pColData.data() + size_t(y) * mip->width;
+				int32_t x = 0;
+
+#if defined(OLC_SSE2)
+				const __m128i mZero = _mm_setzero_si128();
+				const __m128i mTwo = _mm_set1_epi16(2);
+				for (; x * 2 + 3 < src->width && x + 1 < mip->width; x += 2)
+				{
+					const __m128i a = _mm_loadu_si128((const __m128i*)(pRowA + x * 2));
+					const __m128i b = _mm_loadu_si128((const __m128i*)(pRowB + x * 2));
+					const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, mZero), _mm_unpacklo_epi8(b, mZero));
+					const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, mZero), _mm_unpackhi_epi8(b, mZero));
+					const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+					const __m128i avg = _mm_srli_epi16(_mm_add_epi16(sum, mTwo), 2);
+					_mm_storel_epi64((__m128i*)(pOut + x), _mm_packus_epi16(avg, avg));
+				}
+#endif
+				for (; x < mip->width; x++)
+				{
+					const int32_t x0 = std::min(x * 2, src->width - 1), x1 = std::min(x * 2 + 1, src->width - 1);
+					const olc::Pixel p[4] = { pRowA[x0], pRowA[x1], pRowB[x0], pRowB[x1] };
+					pOut[x] = olc::Pixel(
+						uint8_t((p[0].r + p[1].r + p[2].r + p[3].r + 2) >> 2),
+						uint8_t((p[0].g + p[1].g + p[2].g + p[3].g + 2) >> 2),
+						uint8_t((p[0].b + p[1].b + p[2].b + p[3].b + 2) >> 2),
+						uint8_t((p[0].a + p[1].a + p[2].a + p[3].a + 2) >> 2));
+				}
+			}
+
+			vMips.push_back(std::move(mip));
+			src = vMips.back().get();
+		}
+	}
+
+	void Sprite::ClearMips()
+	{
+		vMips.clear();
+	}
+
+	size_t Sprite::GetMipCount() const
+	{ return vMips.size() + 1; }
+
+	const olc::Sprite* Sprite::GetMip(size_t nLevel) const
+	{
+		if (nLevel == 0 || vMips.empty()) return this;
+		return vMips[std::min(nLevel, vMips.size()) - 1].get();
+	}
+
+	const olc::Sprite* Sprite::GetMipForScale(float fTexelsPerPixel) const
+	{
+		// Level n has 2^n texels across for each one of the next level down
+		size_t nLevel = 0;
+		while (nLevel < vMips.size() && fTexelsPerPixel >= 2.0f)
+		{
+			fTexelsPerPixel *= 0.5f;
+			nLevel++;
+		}
+		return GetMip(nLevel);
+	}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::Decal IMPLEMENTATION                                                    |
+	// O------------------------------------------------------------------------------O
+	Decal::Decal(olc::Sprite* spr, bool filter, bool clamp, bool gpuonly, bool mipmap)
+	{
+		id = -1;
+		if (spr == nullptr) return;
+		sprite = spr;
+		bMipmap = mipmap;
+		id = renderer->CreateTexture(sprite->width, sprite->height, filter, clamp);
+		// A full mip chain adds a third again
+		nTextureBytes = size_t(sprite->width) * size_t(sprite->height) * sizeof(olc::Pixel);
+		if (bMipmap) nTextureBytes += nTextureBytes / 3;
+		MemoryTracker::Allocate(MemoryTracker::TEXTURES, nTextureBytes);
+		Update();
+
+		if (gpuonly)
+		{
+			sprite->pColData.clear();
+			sprite->pColData.shrink_to_fit();
+			sprite->ClearMips();
+		}
+	}
+
+	Decal::Decal(const uint32_t nExistingTextureResource, olc::Sprite* spr)
+	{
+		if (spr == nullptr) return;
+		id = nExistingTextureResource;
+	}
+
+	void Decal::Update()
+	{
+		if (sprite == nullptr) return;
+		vUVScale = { 1.0f / float(sprite->width), 1.0f / float(sprite->height) };
+		// Nothing to upload if the pixels have been released
+		if (sprite->pColData.empty()) return;
+		renderer->ApplyTexture(id);
+		if (bMipmap)
+		{
+			// Update() is the signal that the pixels changed, however they were written
+			sprite->GenerateMips();
+			renderer->UpdateTextureMips(id, sprite);
+			for (size_t i = 0; i < sprite->GetMipCount(); i++)
+				nTextureUploadBytes.fetch_add(sprite->GetMip(i)->pColData.size() * sizeof(olc::Pixel), std::memory_order_relaxed);
+		}
+		else
+		{
+			renderer->UpdateTexture(id, sprite);
+			nTextureUploadBytes.fetch_add(sprite->pColData.size() * sizeof(olc::Pixel), std::memory_order_relaxed);
+		}
+	}
+
+	void Decal::UpdateSprite()
+	{
+		if (sprite == nullptr) return;
+		sprite->pColData.resize(size_t(sprite->width) * size_t(sprite->height));
+		renderer->ApplyTexture(id);
+		renderer->ReadTexture(id, sprite);
+	}
+
+	Decal::~Decal()
+	{
+		if (id != -1)
+		{
+			renderer->DeleteTexture(id);
+			MemoryTracker::Release(MemoryTracker::TEXTURES, nTextureBytes);
+			id = -1;
+		}
+	}
+
+	void Renderable::Create(uint32_t width, uint32_t height, bool filter, bool clamp)
 	{
 		pSprite = std::make_unique<olc::Sprite>(width, height);
 		pDecal = std::make_unique<olc::Decal>(pSprite.get(), filter, clamp);
 	}
 
-	olc::rcode Renderable::Load(const std::string& sFile, ResourcePack* pack, bool filter, bool clamp)
+	olc::rcode Renderable::Load(const std::string& sFile, ResourcePack* pack, bool filter, bool clamp, bool gpuonly, bool mipmap)
 	{
 		pSprite = std::make_unique<olc::Sprite>();
 		if (pSprite->LoadFromFile(sFile, pack) == olc::rcode::OK)
 		{
-			pDecal = std::make_unique<olc::Decal>(pSprite.get(), filter, clamp);
+			pDecal = std::make_unique<olc::Decal>(pSprite.get(), filter, clamp, gpuonly, mipmap);
 			return olc::rcode::OK;
 		}
 		else
@@ -1759,6 +3383,28 @@ namespace olc
 		}
 	}
 
+	std::future<olc::rcode> Renderable::LoadDeferred(const std::string& sFile, ResourcePack* pack, bool filter, bool clamp, bool gpuonly, bool mipmap)
+	{
+		pDecal.reset();
+		pSprite = std::make_unique<olc::Sprite>();
+		if (pSprite->LoadFromFile(sFile, pack) != olc::rcode::OK)
+		{
+			pSprite.reset();
+			std::promise<olc::rcode> p;
+			p.set_value(olc::rcode::NO_FILE);
+			return p.get_future();
+		}
+
+		// Sprite is ready, the texture must be made by the thread owning the context
+		auto task = std::make_shared<std::packaged_task<olc::rcode()>>([this, filter, clamp, gpuonly, mipmap]()
+		{
+			pDecal = std::make_unique<olc::Decal>(pSprite.get(), filter, clamp, gpuonly, mipmap);
+			return olc::rcode::OK;
+		});
+		Renderer::ptrPGE->QueueGPUTask([task]() { (*task)(); }, pSprite->pColData.size() * sizeof(olc::Pixel));
+		return task->get_future();
+	}
+
 	olc::Decal* Renderable::Decal() const
 	{ return pDecal.get(); }
 
@@ -1776,10 +3422,24 @@ namespace olc
 	ResourceBuffer::ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size)
 	{
 		vMemory.resize(size);
+		nTrackedBytes = vMemory.capacity();
+		MemoryTracker::Allocate(MemoryTracker::RESOURCE_PACKS, nTrackedBytes);
 		ifs.seekg(offset); ifs.read(vMemory.data(), vMemory.size());
 		setg(vMemory.data(), vMemory.data(), vMemory.data() + size);
 	}
 
+	ResourceBuffer::ResourceBuffer(ResourceBuffer&& rb) : std::streambuf(rb), vMemory(std::move(rb.vMemory)), nTrackedBytes(rb.nTrackedBytes)
+	{
+		// The read position carries over, the buffer it points into moved with vMemory
+		const std::ptrdiff_t nPos = gptr() - eback();
+		setg(vMemory.data(), vMemory.data() + nPos, vMemory.data() + vMemory.size());
+		rb.nTrackedBytes = 0;
+		rb.setg(nullptr, nullptr, nullptr);
+	}
+
+	ResourceBuffer::~ResourceBuffer()
+	{ MemoryTracker::Release(MemoryTracker::RESOURCE_PACKS, nTrackedBytes); }
+
 	ResourcePack::ResourcePack() { }
 	ResourcePack::~ResourcePack() { baseFile.close(); }
 
@@ -1940,6 +3600,235 @@ namespace olc
 		return o;
 	};
 
+	// O------------------------------------------------------------------------------O
+	// | Built in font, decoded at compile time                                       |
+	// O------------------------------------------------------------------------------O
+	struct FontSheet
+	{
+		static constexpr int32_t nWidth = 128;
+		static constexpr int32_t nHeight = 48;
+
+		static constexpr char sData[] =
+			"?Q`0001oOch0o01o@F40o0<AGD4090LAGD<090@A7ch0?00O7Q`0600>00000000"
+			"O000000nOT0063Qo4d8>?7a14Gno94AA4gno94AaOT0>o3`oO400o7QN00000400"
+			"Of80001oOg<7O7moBGT7O7lABET024@aBEd714AiOdl717a_=TH013Q>00000000"
+			"720D000V?V5oB3Q_HdUoE7a9@DdDE4A9@DmoE4A;Hg]oM4Aj8S4D84@`00000000"
+			"OaPT1000Oa`^13P1@AI[?g`1@A=[OdAoHgljA4Ao?WlBA7l1710007l100000000"
+			"ObM6000oOfMV?3QoBDD`O7a0BDDH@5A0BDD<@5A0BGeVO5ao@CQR?5Po00000000"
+			"Oc``000?Ogij70PO2D]??0Ph2DUM@7i`2DTg@7lh2GUj?0TO0C1870T?00000000"
+			"70<4001o?P<7?1QoHg43O;`h@GT0@:@LB@d0>:@hN@L0@?aoN@<0O7ao0000?000"
+			"OcH0001SOglLA7mg24TnK7ln24US>0PL24U140PnOgl0>7QgOcH0K71S0000A000"
+			"00H00000@Dm1S007@DUSg00?OdTnH7YhOfTL<7Yh@Cl0700?@Ah0300700000000"
+			"<008001QL00ZA41a@6HnI<1i@FHLM81M@@0LG81?O`0nC?Y7?`0ZA7Y300080000"
+			"O`082000Oh0827mo6>Hn?Wmo?6HnMb11MP08@C11H`08@FP0@@0004@000000000"
+			"00P00001Oab00003OcKP0006@6=PMgl<@440MglH@000000`@000001P00000000"
+			"Ob@8@@00Ob@8@Ga13R@8Mga172@8?PAo3R@827QoOb@820@0O`0007`0000007P0"
+			"O`000P08Od400g`<3V=P0G`673IP0`@3>1`00P@6O`P00g`<O`000GP800000000"
+			"?P9PL020O`<`N3R0@E4HC7b0@ET<ATB0@@l6C4B0O`H3N7b0?P01L3R000000020";
+
+		// High nibble is the first column used by proportional text, low nibble its width
+		static constexpr std::array<uint8_t, 96> vSpacing = { {
+			0x03,0x25,0x16,0x08,0x07,0x08,0x08,0x04,0x15,0x15,0x08,0x07,0x15,0x07,0x24,0x08,
+			0x08,0x17,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x24,0x15,0x06,0x07,0x16,0x17,
+			0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x17,0x08,0x08,0x08,
+			0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x08,0x08,0x17,0x08,0x15,0x08,0x15,0x08,0x08,
+			0x24,0x18,0x17,0x17,0x17,0x17,0x17,0x17,0x17,0x33,0x17,0x17,0x33,0x18,0x17,0x17,
+			0x17,0x17,0x17,0x17,0x07,0x17,0x17,0x18,0x18,0x17,0x17,0x07,0x33,0x07,0x08,0x00, } };
+
+		struct Decoded
+		{
+			std::array<uint32_t, nWidth * nHeight> pixels{};
+			// One bit per pixel, bit (y * 8 + x) of each glyph
+			std::array<uint64_t, 96> masks{};
+		};
+
+		static constexpr Decoded Decode()
+		{
+			Decoded d{};
+			int32_t px = 0, py = 0;
+			for (size_t b = 0; b < 1024; b += 4)
+			{
+				uint32_t sym1 = (uint32_t)sData[b + 0] - 48;
+				uint32_t sym2 = (uint32_t)sData[b + 1] - 48;
+				uint32_t sym3 = (uint32_t)sData[b + 2] - 48;
+				uint32_t sym4 = (uint32_t)sData[b + 3] - 48;
+				uint32_t r = sym1 << 18 | sym2 << 12 | sym3 << 6 | sym4;
+
+				for (int i = 0; i < 24; i++)
+				{
+					if (r & (1 << i))
+					{
+						d.pixels[py * nWidth + px] = 0xFFFFFFFF;
+						d.masks[(py / 8) * 16 + px / 8] |= uint64_t(1) << ((py % 8) * 8 + px % 8);
+					}
+					if (++py == nHeight) { px++; py = 0; }
+				}
+			}
+			return d;
+		}
+	};
+
+	static constexpr FontSheet::Decoded fontSheet = FontSheet::Decode();
+
+	// O------------------------------------------------------------------------------O
+	// | Pipelined rendering - Marshals texture work to the render thread             |
+	// O------------------------------------------------------------------------------O
+	struct PipelineState
+	{
+		std::unique_ptr<olc::Renderer> pDevice;
+		std::thread::id idRender;
+		std::mutex mux;
+		// Render thread waits on cvRender, the update thread on cvUpdate
+		std::condition_variable cvRender;
+		std::condition_variable cvUpdate;
+		// Set when a packet is handed over, cleared when it has been displayed
+		bool bFramePending = false;
+		bool bFrameReady = false;
+		bool bQuit = false;
+		// Calls the update thread is waiting on the result of
+		std::deque<std::function<void()>> qCalls;
+		// Texture work recorded since the last packet was handed over
+		std::vector<std::function<void()>> vRecorded;
+	};
+
+	// Takes the place of the renderer while pipelining. Calls from the render thread go straight
+	// through, those from the update thread are recorded for the next frame, or wait for the
+	// render thread when they need an answer
+	class Renderer_Pipelined : public olc::Renderer
+	{
+	public:
+		Renderer_Pipelined(olc::PipelineState& state) : pipe(state), device(*state.pDevice) {}
+
+		void PrepareDevice() override { device.PrepareDevice(); }
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override { return device.CreateDevice(params, bFullScreen, bVSYNC); }
+		olc::rcode DestroyDevice() override { return device.DestroyDevice(); }
+
+		void DisplayFrame() override { Record([this]() { device.DisplayFrame(); }); }
+		void PrepareDrawing() override { Record([this]() { device.PrepareDrawing(); }); }
+		void SetDecalMode(const olc::DecalMode& mode) override { Record([this, mode]() { device.SetDecalMode(mode); }); }
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{ Record([this, offset, scale, tint]() { device.DrawLayerQuad(offset, scale, tint); }); }
+		void DrawDecal(const olc::DecalInstance& decal) override
+		{
+			if (OnRenderThread()) device.DrawDecal(decal);
+			else Record([this, decal]() { device.DrawDecal(decal); });
+		}
+		void ApplyTexture(uint32_t id) override { Record([this, id]() { device.ApplyTexture(id); }); }
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override { Record([this, pos, size]() { device.UpdateViewport(pos, size); }); }
+		void ClearBuffer(olc::Pixel p, bool bDepth) override { Record([this, p, bDepth]() { device.ClearBuffer(p, bDepth); }); }
+		// Only meaningful on the render thread, which is the one drawing
+		uint32_t GetDrawCalls() const override { return device.GetDrawCalls(); }
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered, const bool clamp) override
+		{ return Call([&]() { return device.CreateTexture(width, height, filtered, clamp); }); }
+
+		void ReadTexture(uint32_t id, olc::Sprite* spr) override
+		{ Call([&]() { device.ReadTexture(id, spr); }); }
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			if (OnRenderThread()) { device.UpdateTexture(id, spr); return; }
+			// The sprite may be drawn to again before the upload happens
+			std::shared_ptr<olc::Sprite> pCopy(spr->Duplicate());
+			Record([this, id, pCopy]() { device.UpdateTexture(id, pCopy.get()); });
+		}
+
+		void UpdateTextureMips(uint32_t id, olc::Sprite* spr) override
+		{
+			if (OnRenderThread()) { device.UpdateTextureMips(id, spr); return; }
+			// The chain has just been brought up to date, so it is copied along with the sprite
+			auto pCopy = std::make_shared<olc::Sprite>();
+			*pCopy = *spr;
+			Record([this, id, pCopy]() { device.UpdateTextureMips(id, pCopy.get()); });
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			if (OnRenderThread()) return device.DeleteTexture(id);
+			// The frame in flight may still draw with this texture, and its decal is about to go
+			std::unique_lock<std::mutex> lock(pipe.mux);
+			pipe.cvUpdate.wait(lock, [this]() { return !pipe.bFramePending; });
+			pipe.vRecorded.push_back([this, id]() { device.DeleteTexture(id); });
+			return id;
+		}
+
+	private:
+		bool OnRenderThread() const
+		{ return std::this_thread::get_id() == pipe.idRender; }
+
+		void Record(std::function<void()> func)
+		{
+			if (OnRenderThread()) { func(); return; }
+			std::unique_lock<std::mutex> lock(pipe.mux);
+			pipe.vRecorded.push_back(std::move(func));
+		}
+
+		template<typename F>
+		auto Call(F&& func) -> decltype(func())
+		{
+			if (OnRenderThread()) return func();
+			std::packaged_task<decltype(func())()> task(std::forward<F>(func));
+			auto result = task.get_future();
+			{
+				// Once the frame in flight is done, anything recorded since must go first
+				std::unique_lock<std::mutex> lock(pipe.mux);
+				pipe.cvUpdate.wait(lock, [this]() { return !pipe.bFramePending; });
+				std::vector<std::function<void()>> vBefore;
+				vBefore.swap(pipe.vRecorded);
+				pipe.qCalls.push_back([&task, vBefore]()
+				{
+					for (auto& command : vBefore) command();
+					task();
+				});
+			}
+			pipe.cvRender.notify_one();
+			return result.get();
+		}
+
+	private:
+		olc::PipelineState& pipe;
+		olc::Renderer& device;
+	};
+
+	// O------------------------------------------------------------------------------O
+	// | Input ring - Lock free queue of input events from the platform to the engine |
+	// O------------------------------------------------------------------------------O
+	// One producer, whichever thread the platform reports input on, and one consumer,
+	// the thread running olc_CoreUpdate()
+	struct InputRing
+	{
+		// Several seconds of a stalled frame with the mouse moving
+		static constexpr uint32_t nCapacity = 4096;
+		std::array<olc::InputEvent, nCapacity> vEvents;
+		alignas(64) std::atomic<uint32_t> nHead{ 0 };
+		alignas(64) std::atomic<uint32_t> nTail{ 0 };
+		std::atomic<uint32_t> nDropped{ 0 };
+		// Mouse position of the newest event offered, dropped or not, packed as x then y
+		std::atomic<uint64_t> nLastPos{ 0 };
+
+		void Push(const olc::InputEvent& e)
+		{
+			nLastPos.store((uint64_t(uint32_t(e.vPos.x)) << 32) | uint32_t(e.vPos.y), std::memory_order_relaxed);
+			const uint32_t nWrite = nHead.load(std::memory_order_relaxed);
+			if (nWrite - nTail.load(std::memory_order_acquire) == nCapacity)
+			{
+				nDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			vEvents[nWrite & (nCapacity - 1)] = e;
+			nHead.store(nWrite + 1, std::memory_order_release);
+		}
+
+		bool Pop(olc::InputEvent& e)
+		{
+			const uint32_t nRead = nTail.load(std::memory_order_relaxed);
+			if (nRead == nHead.load(std::memory_order_acquire)) return false;
+			e = vEvents[nRead & (nCapacity - 1)];
+			nTail.store(nRead + 1, std::memory_order_release);
+			return true;
+		}
+	};
+
 	// O------------------------------------------------------------------------------O
 	// | olc::PixelGameEngine IMPLEMENTATION                                          |
 	// O------------------------------------------------------------------------------O
@@ -1947,6 +3836,7 @@ namespace olc
 	{
 		sAppName = "Undefined";
 		olc::PGEX::pge = this;
+		pInputRing = std::make_unique<olc::InputRing>();
 
 		// Bring in relevant Platform & Rendering systems depending
 		// on compiler parameters
@@ -1954,7 +3844,10 @@ namespace olc
 	}
 
 	PixelGameEngine::~PixelGameEngine()
-	{}
+	{
+		// Jobs may still refer to the application
+		jobs.Stop();
+	}
 
 
 	olc::rcode PixelGameEngine::Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h, bool full_screen, bool vsync, bool cohesion)
@@ -2015,6 +3908,25 @@ namespace olc
 	}
 #endif
 
+	void PixelGameEngine::EnablePipelinedRendering(bool bEnable)
+	{ bPipelinedRendering = bEnable; }
+
+	void PixelGameEngine::SetFrameRateLimit(float fFramesPerSecond)
+	{ fFrameRateLimit = fFramesPerSecond; }
+
+	void PixelGameEngine::SetIdleFrameRate(float fFramesPerSecond)
+	{ fIdleFrameRate = fFramesPerSecond; }
+
+	void PixelGameEngine::SetSceneStatic(bool bStatic)
+	{ bSceneStatic = bStatic; }
+
+	void PixelGameEngine::EnableFrameTimeSmoothing(bool bEnable)
+	{
+		bFrameTimeSmoothing = bEnable;
+		fFrameTimeAverage = 0.0f;
+		fFrameTimeDebt = 0.0f;
+	}
+
 	void PixelGameEngine::SetDrawTarget(Sprite* target)
 	{
 		if (target)
@@ -2122,6 +4034,15 @@ namespace olc
 	float PixelGameEngine::GetElapsedTime() const
 	{ return fLastElapsed; }
 
+	const olc::FrameStats& PixelGameEngine::GetFrameStats() const
+	{ return statsFrame; }
+
+	const std::vector<olc::InputEvent>& PixelGameEngine::GetInputEvents() const
+	{ return vInputEvents; }
+
+	olc::JobSystem& PixelGameEngine::GetJobSystem()
+	{ return jobs; }
+
 	const olc::vi2d& PixelGameEngine::GetWindowSize() const
 	{ return vWindowSize; }
 
@@ -2181,87 +4102,104 @@ namespace olc
 
 	void PixelGameEngine::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, uint32_t pattern)
 	{
-		int x, y, dx, dy, dx1, dy1, px, py, xe, ye, i;
-		dx = x2 - x1; dy = y2 - y1;
+		if (!pDrawTarget) return;
+		const int32_t w = pDrawTarget->width, h = pDrawTarget->height;
+
+		// Cohen-Sutherland outcodes - both ends beyond the same edge means nothing to draw
+		auto outcode = [&](int32_t x, int32_t y) { return int(x < 0) | int(x >= w) << 1 | int(y < 0) << 2 | int(y >= h) << 3; };
+		if (outcode(x1, y1) & outcode(x2, y2)) return;
 
-		auto rol = [&](void) { pattern = (pattern << 1) | (pattern >> 31); return pattern & 1; };
+		// Rather than move the end points, which would bend the line, the range of steps
+		// that land on the target is found and only those are walked. Pixel n of the
+		// line uses bit n + 1 of the rotating pattern, so skipped pixels are accounted for
+		const bool bSolid = pattern == 0xFFFFFFFF;
+		const bool bOverwrite = nPixelMode == Pixel::NORMAL || (nPixelMode == Pixel::MASK && p.a == 255);
+		auto bit = [&](int32_t n) { return ((pattern >> ((31 - n) & 31)) & 1) != 0; };
+		auto plot = [&](int32_t x, int32_t y)
+		{
+			if (bOverwrite) pDrawTarget->pColData[size_t(y) * w + x] = p;
+			else if (nPixelMode == Pixel::CUSTOM) Draw(x, y, p);
+			else FillSpan(pDrawTarget->pColData.data() + size_t(y) * w + x, p, 1);
+		};
 
-		olc::vi2d p1(x1, y1), p2(x2, y2);
-		//if (!ClipLineToScreen(p1, p2))
-		//	return;
-		x1 = p1.x; y1 = p1.y;
-		x2 = p2.x; y2 = p2.y;
+		int32_t dx = x2 - x1, dy = y2 - y1;
 
 		// straight lines idea by gurkanctn
-		if (dx == 0) // Line is vertical
+		if (dy == 0) // Line is horizontal
 		{
-			if (y2 < y1) std::swap(y1, y2);
-			for (y = y1; y <= y2; y++) if (rol()) Draw(x1, y, p);
+			if (x2 < x1) std::swap(x1, x2);
+			const int32_t xs = std::max(x1, 0), xe = std::min(x2, w - 1);
+			if (bSolid) { DrawSpan(xs, xe, y1, p); return; }
+			for (int32_t x = xs; x <= xe; x++)
+			{
+				if (!bit(x - x1)) continue;
+				int32_t e = x;
+				while (e < xe && bit(e + 1 - x1)) e++;
+				DrawSpan(x, e, y1, p);
+				x = e;
+			}
 			return;
 		}
 
-		if (dy == 0) // Line is horizontal
+		if (dx == 0) // Line is vertical
 		{
-			if (x2 < x1) std::swap(x1, x2);
-			for (x = x1; x <= x2; x++) if (rol()) Draw(x, y1, p);
+			if (y2 < y1) std::swap(y1, y2);
+			const int32_t ys = std::max(y1, 0), ye = std::min(y2, h - 1);
+			for (int32_t y = ys; y <= ye; y++) if (bSolid || bit(y - y1)) plot(x1, y);
 			return;
 		}
 
-		// Line is Funk-aye
-		dx1 = abs(dx); dy1 = abs(dy);
-		px = 2 * dy1 - dx1;	py = 2 * dx1 - dy1;
-		if (dy1 <= dx1)
-		{
-			if (dx >= 0)
-			{
-				x = x1; y = y1; xe = x2;
-			}
-			else
-			{
-				x = x2; y = y2; xe = x1;
-			}
+		// Line is Funk-aye. Walk the major axis from its lower end, the minor axis moves
+		// by sign every time the accumulated error crosses a whole pixel. The rounding
+		// bias matches the original Bresenham loops exactly
+		const bool bXMajor = std::abs(dy) <= std::abs(dx);
+		if (bXMajor ? dx < 0 : dy < 0) { std::swap(x1, x2); std::swap(y1, y2); }
+		const int32_t a0 = bXMajor ? x1 : y1, b0 = bXMajor ? y1 : x1;
+		const int32_t nSteps = std::abs(bXMajor ? dx : dy), nMinor = std::abs(bXMajor ? dy : dx);
+		const int32_t nSign = ((dx < 0) == (dy < 0)) ? 1 : -1;
+		const int32_t nLimA = bXMajor ? w : h, nLimB = bXMajor ? h : w;
+		const int64_t nDenom = 2 * int64_t(nSteps), nBias = bXMajor ? nSteps : nSteps - 1;
+		auto minorSteps = [&](int64_t i) { return (2 * int64_t(nMinor) * i + nBias) / nDenom; };
+
+		// First step at which the minor axis has moved at least k pixels
+		auto firstStep = [&](int64_t k)
+		{
+			int64_t lo = 0, hi = int64_t(nSteps) + 1;
+			while (lo < hi) { int64_t mid = (lo + hi) / 2; if (minorSteps(mid) >= k) hi = mid; else lo = mid + 1; }
+			return lo;
+		};
 
-			if (rol()) Draw(x, y, p);
+		const int64_t kLo = nSign > 0 ? -int64_t(b0) : int64_t(b0) - (nLimB - 1);
+		const int64_t kHi = nSign > 0 ? int64_t(nLimB - 1) - b0 : int64_t(b0);
+		const int64_t iStart = std::max({ int64_t(0), -int64_t(a0), firstStep(kLo) });
+		const int64_t iEnd = std::min({ int64_t(nSteps), int64_t(nLimA - 1) - a0, firstStep(kHi + 1) - 1 });
 
-			for (i = 0; x < xe; i++)
-			{
-				x = x + 1;
-				if (px < 0)
-					px = px + 2 * dy1;
-				else
-				{
-					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) y = y + 1; else y = y - 1;
-					px = px + 2 * (dy1 - dx1);
-				}
-				if (rol()) Draw(x, y, p);
-			}
-		}
-		else
+		int64_t k = minorSteps(iStart), r = (2 * int64_t(nMinor) * iStart + nBias) % nDenom;
+		for (int64_t i = iStart; i <= iEnd; i++)
 		{
-			if (dy >= 0)
-			{
-				x = x1; y = y1; ye = y2;
-			}
-			else
+			if (bSolid || bit(int32_t(i)))
 			{
-				x = x2; y = y2; ye = y1;
+				const int32_t a = a0 + int32_t(i), b = b0 + nSign * int32_t(k);
+				if (bXMajor) plot(a, b); else plot(b, a);
 			}
+			r += 2 * int64_t(nMinor);
+			if (r >= nDenom) { r -= nDenom; k++; }
+		}
+	}
 
-			if (rol()) Draw(x, y, p);
+	void PixelGameEngine::DrawSpan(int32_t x1, int32_t x2, int32_t y, Pixel p)
+	{
+		if (!pDrawTarget || y < 0 || y >= pDrawTarget->height) return;
+		x1 = std::max(x1, 0); x2 = std::min(x2, pDrawTarget->width - 1);
+		if (x1 > x2) return;
 
-			for (i = 0; y < ye; i++)
-			{
-				y = y + 1;
-				if (py <= 0)
-					py = py + 2 * dx1;
-				else
-				{
-					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) x = x + 1; else x = x - 1;
-					py = py + 2 * (dx1 - dy1);
-				}
-				if (rol()) Draw(x, y, p);
-			}
+		if (nPixelMode == Pixel::CUSTOM)
+		{
+			for (int32_t x = x1; x <= x2; x++) Draw(x, y, p);
+			return;
 		}
+
+		FillSpan(pDrawTarget->pColData.data() + size_t(y) * pDrawTarget->width + x1, p, x2 - x1 + 1);
 	}
 
 	void PixelGameEngine::DrawCircle(const olc::vi2d& pos, int32_t radius, Pixel p, uint8_t mask)
@@ -2317,16 +4255,10 @@ namespace olc
 			int y0 = radius;
 			int d = 3 - 2 * radius;
 
-			auto drawline = [&](int sx, int ex, int y)
-			{
-				for (int x = sx; x <= ex; x++)
-					Draw(x, y, p);
-			};
-
 			while (y0 >= x0)
 			{
-				drawline(x - y0, x + y0, y - x0);
-				if (x0 > 0)	drawline(x - y0, x + y0, y + x0);
+				DrawSpan(x - y0, x + y0, y - x0, p);
+				if (x0 > 0)	DrawSpan(x - y0, x + y0, y + x0, p);
 
 				if (d < 0)
 					d += 4 * x0++ + 6;
@@ -2334,8 +4266,8 @@ namespace olc
 				{
 					if (x0 != y0)
 					{
-						drawline(x - x0, x + x0, y - y0);
-						drawline(x - x0, x + x0, y + y0);
+						DrawSpan(x - x0, x + x0, y - y0, p);
+						DrawSpan(x - x0, x + x0, y + y0, p);
 					}
 					d += 4 * (x0++ - y0--) + 10;
 				}
@@ -2350,10 +4282,16 @@ namespace olc
 
 	void PixelGameEngine::DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p)
 	{
-		DrawLine(x, y, x + w, y, p);
-		DrawLine(x + w, y, x + w, y + h, p);
-		DrawLine(x + w, y + h, x, y + h, p);
-		DrawLine(x, y + h, x, y, p);
+		int32_t x1 = std::min(x, x + w), x2 = std::max(x, x + w);
+		int32_t y1 = std::min(y, y + h), y2 = std::max(y, y + h);
+
+		// Each edge pixel is visited once, so blended corners are not doubled up
+		DrawSpan(x1, x2, y1, p);
+		if (y2 == y1) return;
+		DrawSpan(x1, x2, y2, p);
+		if (y2 - y1 < 2) return;
+		DrawLine(x1, y1 + 1, x1, y2 - 1, p);
+		if (x2 != x1) DrawLine(x2, y1 + 1, x2, y2 - 1, p);
 	}
 
 	void PixelGameEngine::Clear(Pixel p)
@@ -2426,9 +4364,8 @@ namespace olc
 		if (y2 < 0) y2 = 0;
 		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
 
-		for (int i = x; i < x2; i++)
-			for (int j = y; j < y2; j++)
-				Draw(i, j, p);
+		for (int j = y; j < y2; j++)
+			DrawSpan(x, x2 - 1, j, p);
 	}
 
 	void PixelGameEngine::DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
@@ -2447,7 +4384,7 @@ namespace olc
 	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+		auto drawline = [&](int sx, int ex, int ny) { DrawSpan(sx, ex, ny, p); };
 
 		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
 		bool changed1 = false;
@@ -2582,166 +4519,312 @@ namespace olc
 
 	void PixelGameEngine::FillTexturedTriangle(const std::vector<olc::vf2d>& vPoints, std::vector<olc::vf2d> vTex, std::vector<olc::Pixel> vColour, olc::Sprite* sprTex)
 	{
-		olc::vi2d p1 = vPoints[0];
-		olc::vi2d p2 = vPoints[1];
-		olc::vi2d p3 = vPoints[2];
+		if (vPoints.size() < 3 || vTex.size() < 3 || vColour.size() < 3)
+			return;
+
+		vRasterTris.clear();
+		RasterTriangle tri;
+		if (SetupTriangle(vPoints.data(), vTex.data(), vColour.data(), tri))
+			vRasterTris.push_back(tri);
+		RasteriseTriangles(vRasterTris, sprTex);
+	}
+
+	void PixelGameEngine::FillTexturedPolygon(const std::vector<olc::vf2d>& vPoints, const std::vector<olc::vf2d>& vTex, const std::vector<olc::Pixel>& vColour, olc::Sprite* sprTex, olc::DecalStructure structure)
+	{
+		if (structure == olc::DecalStructure::LINE)
+		{
+			return; // Meaningless, so do nothing
+		}
 
-		if (p2.y < p1.y){std::swap(p1.y, p2.y); std::swap(p1.x, p2.x); std::swap(vTex[0].x, vTex[1].x); std::swap(vTex[0].y, vTex[1].y); std::swap(vColour[0], vColour[1]);}
-		if (p3.y < p1.y){std::swap(p1.y, p3.y); std::swap(p1.x, p3.x); std::swap(vTex[0].x, vTex[2].x); std::swap(vTex[0].y, vTex[2].y); std::swap(vColour[0], vColour[2]);}
-		if (p3.y < p2.y){std::swap(p2.y, p3.y); std::swap(p2.x, p3.x); std::swap(vTex[1].x, vTex[2].x); std::swap(vTex[1].y, vTex[2].y); std::swap(vColour[1], vColour[2]);}
+		if (vPoints.size() < 3 || vTex.size() < 3 || vColour.size() < 3)
+			return;
+
+		// Every triangle is gathered first so the whole polygon is binned and filled in one go
+		vRasterTris.clear();
+		RasterTriangle tri;
+		auto add = [&](size_t i0, size_t i1, size_t i2)
+		{
+			const olc::vf2d vP[3] = { vPoints[i0], vPoints[i1], vPoints[i2] };
+			const olc::vf2d vT[3] = { vTex[i0], vTex[i1], vTex[i2] };
+			const olc::Pixel vC[3] = { vColour[i0], vColour[i1], vColour[i2] };
+			if (SetupTriangle(vP, vT, vC, tri)) vRasterTris.push_back(tri);
+		};
 
-		olc::vi2d dPos1 = p2 - p1;
-		olc::vf2d dTex1 = vTex[1] - vTex[0];
-		int dcr1 = vColour[1].r - vColour[0].r;
-		int dcg1 = vColour[1].g - vColour[0].g;
-		int dcb1 = vColour[1].b - vColour[0].b;
-		int dca1 = vColour[1].a - vColour[0].a;
+		const size_t nVerts = std::min({ vPoints.size(), vTex.size(), vColour.size() });
 
-		olc::vi2d dPos2 = p3 - p1;
-		olc::vf2d dTex2 = vTex[2] - vTex[0];
-		int dcr2 = vColour[2].r - vColour[0].r;
-		int dcg2 = vColour[2].g - vColour[0].g;
-		int dcb2 = vColour[2].b - vColour[0].b;
-		int dca2 = vColour[2].a - vColour[0].a;
+		if (structure == olc::DecalStructure::LIST)
+		{
+			for (size_t i = 0; i + 2 < nVerts; i += 3)
+				add(i, i + 1, i + 2);
+		}
 
-		float dax_step = 0, dbx_step = 0, dcr1_step = 0, dcr2_step = 0,	dcg1_step = 0, dcg2_step = 0, dcb1_step = 0, dcb2_step = 0,	dca1_step = 0, dca2_step = 0;
-		olc::vf2d vTex1Step, vTex2Step;
+		if (structure == olc::DecalStructure::STRIP)
+		{
+			for (size_t i = 2; i < nVerts; i++)
+				add(i - 2, i - 1, i);
+		}
 
-		if (dPos1.y)
+		if (structure == olc::DecalStructure::FAN)
 		{
-			dax_step = dPos1.x / (float)abs(dPos1.y);
-			vTex1Step = dTex1 / (float)abs(dPos1.y);
-			dcr1_step = dcr1 / (float)abs(dPos1.y);
-			dcg1_step = dcg1 / (float)abs(dPos1.y);
-			dcb1_step = dcb1 / (float)abs(dPos1.y);
-			dca1_step = dca1 / (float)abs(dPos1.y);
+			for (size_t i = 2; i < nVerts; i++)
+				add(0, i - 1, i);
 		}
 
-		if (dPos2.y)
+		RasteriseTriangles(vRasterTris, sprTex);
+	}
+
+	bool PixelGameEngine::SetupTriangle(const olc::vf2d* pPos, const olc::vf2d* pTex, const olc::Pixel* pCol, RasterTriangle& tri) const
+	{
+		if (pDrawTarget == nullptr) return false;
+
+		// Snap to 1/16th of a pixel. Anything further out than this could overflow the edge equations
+		int64_t X[3], Y[3];
+		for (int i = 0; i < 3; i++)
 		{
-			dbx_step = dPos2.x / (float)abs(dPos2.y);
-			vTex2Step = dTex2 / (float)abs(dPos2.y);
-			dcr2_step = dcr2 / (float)abs(dPos2.y);
-			dcg2_step = dcg2 / (float)abs(dPos2.y);
-			dcb2_step = dcb2 / (float)abs(dPos2.y);
-			dca2_step = dca2 / (float)abs(dPos2.y);
+			if (!(std::abs(pPos[i].x) < 1048576.0f && std::abs(pPos[i].y) < 1048576.0f)) return false;
+			X[i] = int64_t(std::floor(pPos[i].x * 16.0f + 0.5f));
+			Y[i] = int64_t(std::floor(pPos[i].y * 16.0f + 0.5f));
 		}
 
-		olc::vi2d vStart;
-		olc::vi2d vEnd;
-		int vStartIdx;
+		// Either winding is accepted, the edge equations want it one way round
+		int v[3] = { 0, 1, 2 };
+		int64_t nArea = (X[1] - X[0]) * (Y[2] - Y[0]) - (Y[1] - Y[0]) * (X[2] - X[0]);
+		if (nArea == 0) return false;
+		if (nArea < 0) { std::swap(v[1], v[2]); nArea = -nArea; }
 
-		for (int pass = 0; pass < 2; pass++)
+		// Pixel centres are at 16 * x + 8
+		auto floordiv = [](int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+		tri.x0 = int32_t(std::max<int64_t>(floordiv(std::min({ X[0], X[1], X[2] }) + 7, 16), 0));
+		tri.y0 = int32_t(std::max<int64_t>(floordiv(std::min({ Y[0], Y[1], Y[2] }) + 7, 16), 0));
+		tri.x1 = int32_t(std::min<int64_t>(floordiv(std::max({ X[0], X[1], X[2] }) - 8, 16) + 1, pDrawTarget->width));
+		tri.y1 = int32_t(std::min<int64_t>(floordiv(std::max({ Y[0], Y[1], Y[2] }) - 8, 16) + 1, pDrawTarget->height));
+		if (tri.x0 >= tri.x1 || tri.y0 >= tri.y1) return false;
+
+		// Edge i is opposite vertex i, so divided by the area it is that vertex's barycentric
+		// weight, which as a plane over pixel coordinates interpolates the attributes
+		const double fInvArea = 1.0 / double(nArea);
+		double fWeight[3][3];
+		for (int i = 0; i < 3; i++)
 		{
-			if (pass == 0)
-			{
-				vStart = p1; vEnd = p2;	vStartIdx = 0;
-			}
-			else
-			{
-				dPos1 = p3 - p2;
-				dTex1 = vTex[2] - vTex[1];
-				dcr1 = vColour[2].r - vColour[1].r;
-				dcg1 = vColour[2].g - vColour[1].g;
-				dcb1 = vColour[2].b - vColour[1].b;
-				dca1 = vColour[2].a - vColour[1].a;
-				dcr1_step = 0; dcg1_step = 0; dcb1_step = 0; dca1_step = 0;
+			const int a = v[(i + 1) % 3], b = v[(i + 2) % 3];
+			tri.A[i] = Y[a] - Y[b];
+			tri.B[i] = X[b] - X[a];
+			tri.C[i] = -(tri.A[i] * X[a] + tri.B[i] * Y[a]);
+			fWeight[i][0] = double(8 * tri.A[i] + 8 * tri.B[i] + tri.C[i]) * fInvArea;
+			fWeight[i][1] = double(16 * tri.A[i]) * fInvArea;
+			fWeight[i][2] = double(16 * tri.B[i]) * fInvArea;
+
+			// Top-left rule, a pixel centre exactly on an edge shared by two
+			// triangles belongs to only one of them
+			if (!(tri.A[i] > 0 || (tri.A[i] == 0 && tri.B[i] > 0))) tri.C[i] -= 1;
+		}
 
-				if (dPos2.y) dbx_step = dPos2.x / (float)abs(dPos2.y);
-				if (dPos1.y)
+		for (int c = 0; c < 4; c++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				double f = 0.0;
+				for (int i = 0; i < 3; i++)
 				{
-					dax_step = dPos1.x / (float)abs(dPos1.y);
-					vTex1Step = dTex1 / (float)abs(dPos1.y);
-					dcr1_step = dcr1 / (float)abs(dPos1.y);
-					dcg1_step = dcg1 / (float)abs(dPos1.y);
-					dcb1_step = dcb1 / (float)abs(dPos1.y);
-					dca1_step = dca1 / (float)abs(dPos1.y);
+					const olc::Pixel& p = pCol[v[i]];
+					const uint8_t nChannel[4] = { p.r, p.g, p.b, p.a };
+					f += fWeight[i][k] * double(nChannel[c]);
 				}
-
-				vStart = p2; vEnd = p3; vStartIdx = 1;
+				tri.nCol[c][k] = int64_t(std::floor(f * 65536.0 + (k == 0 ? 32768.0 : 0.5)));
 			}
+		}
 
-			if (dPos1.y)
+		for (int k = 0; k < 3; k++)
+		{
+			tri.fTex[0][k] = tri.fTex[1][k] = 0.0;
+			for (int i = 0; i < 3; i++)
 			{
-				for (int i = vStart.y; i <= vEnd.y; i++)
-				{
-					int ax = int(vStart.x + (float)(i - vStart.y) * dax_step);
-					int bx = int(p1.x + (float)(i - p1.y) * dbx_step);
+				tri.fTex[0][k] += fWeight[i][k] * double(pTex[v[i]].x);
+				tri.fTex[1][k] += fWeight[i][k] * double(pTex[v[i]].y);
+			}
+		}
+
+		return true;
+	}
 
-					olc::vf2d tex_s(vTex[vStartIdx].x + (float)(i - vStart.y) * vTex1Step.x, vTex[vStartIdx].y + (float)(i - vStart.y) * vTex1Step.y);
-					olc::vf2d tex_e(vTex[0].x + (float)(i - p1.y) * vTex2Step.x, vTex[0].y + (float)(i - p1.y) * vTex2Step.y);
+	void PixelGameEngine::RasteriseTriangles(const std::vector<RasterTriangle>& vTris, const olc::Sprite* sprTex)
+	{
+		if (vTris.empty() || pDrawTarget == nullptr) return;
 
-					olc::Pixel col_s(vColour[vStartIdx].r + uint8_t((float)(i - vStart.y) * dcr1_step), vColour[vStartIdx].g + uint8_t((float)(i - vStart.y) * dcg1_step),
-						vColour[vStartIdx].b + uint8_t((float)(i - vStart.y) * dcb1_step), vColour[vStartIdx].a + uint8_t((float)(i - vStart.y) * dca1_step));
+		// Custom pixel functions may not be thread safe, and small jobs are not worth handing out
+		int64_t nArea = 0;
+		for (const auto& t : vTris) nArea += int64_t(t.x1 - t.x0) * int64_t(t.y1 - t.y0);
+		if (nPixelMode == Pixel::CUSTOM || nArea < 16384)
+		{
+			for (const auto& t : vTris) RasteriseTile(t, t.x0, t.y0, t.x1, t.y1, sprTex);
+			return;
+		}
 
-					olc::Pixel col_e(vColour[0].r + uint8_t((float)(i - p1.y) * dcr2_step), vColour[0].g + uint8_t((float)(i - p1.y) * dcg2_step),
-						vColour[0].b + uint8_t((float)(i - p1.y) * dcb2_step), vColour[0].a + uint8_t((float)(i - p1.y) * dca2_step));
+		constexpr int32_t nTile = 32;
+		const int32_t nTilesX = (pDrawTarget->width + nTile - 1) / nTile;
+		const int32_t nTilesY = (pDrawTarget->height + nTile - 1) / nTile;
+		vRasterBins.resize(size_t(nTilesX) * size_t(nTilesY));
+		for (auto& bin : vRasterBins) bin.clear();
 
-					if (ax > bx) { std::swap(ax, bx); std::swap(tex_s, tex_e); std::swap(col_s, col_e); }
+		// Each tile keeps its triangles in submission order, and no two tiles
+		// share a pixel, so the result is the same however the tiles are shared out
+		for (uint32_t i = 0; i < uint32_t(vTris.size()); i++)
+		{
+			const RasterTriangle& t = vTris[i];
+			for (int32_t ty = t.y0 / nTile; ty <= (t.y1 - 1) / nTile; ty++)
+				for (int32_t tx = t.x0 / nTile; tx <= (t.x1 - 1) / nTile; tx++)
+					vRasterBins[ty * nTilesX + tx].push_back(i);
+		}
 
-					float tstep = 1.0f / ((float)(bx - ax));
-					float t = 0.0f;
+		vRasterTiles.clear();
+		for (uint32_t i = 0; i < uint32_t(vRasterBins.size()); i++)
+			if (!vRasterBins[i].empty()) vRasterTiles.push_back(i);
 
-					for (int j = ax; j < bx; j++)
-					{
-						olc::Pixel pixel = PixelLerp(col_s, col_e, t);
-						if (sprTex != nullptr) pixel *= sprTex->Sample(tex_s.lerp(tex_e, t));
-						Draw(j, i, pixel);
-						t += tstep;
-					}
-				}
+		jobs.ParallelFor(0, uint32_t(vRasterTiles.size()), 1, [&](uint32_t nFirst, uint32_t nLast)
+		{
+			for (uint32_t n = nFirst; n < nLast; n++)
+			{
+				const uint32_t nBin = vRasterTiles[n];
+				const int32_t x = int32_t(nBin % nTilesX) * nTile;
+				const int32_t y = int32_t(nBin / nTilesX) * nTile;
+				for (uint32_t i : vRasterBins[nBin])
+					RasteriseTile(vTris[i], x, y, x + nTile, y + nTile, sprTex);
 			}
-		}			
+		});
 	}
 
-	void PixelGameEngine::FillTexturedPolygon(const std::vector<olc::vf2d>& vPoints, const std::vector<olc::vf2d>& vTex, const std::vector<olc::Pixel>& vColour, olc::Sprite* sprTex, olc::DecalStructure structure)
+	void PixelGameEngine::RasteriseTile(const RasterTriangle& tri, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const olc::Sprite* sprTex)
 	{
-		if (structure == olc::DecalStructure::LINE)
+		x0 = std::max(x0, tri.x0); y0 = std::max(y0, tri.y0);
+		x1 = std::min(x1, tri.x1); y1 = std::min(y1, tri.y1);
+		if (x0 >= x1 || y0 >= y1) return;
+
+		// Edges the whole rectangle is inside of need no testing, and
+		// if it is wholly outside any one edge there is nothing to do
+		const int64_t w = x1 - x0 - 1, h = y1 - y0 - 1;
+		int64_t nEdge[3], nStepX[3], nStepY[3];
+		int nEdges = 0;
+		for (int i = 0; i < 3; i++)
 		{
-			return; // Meaningless, so do nothing
+			const int64_t e = tri.A[i] * (16 * int64_t(x0) + 8) + tri.B[i] * (16 * int64_t(y0) + 8) + tri.C[i];
+			const int64_t dx = 16 * tri.A[i], dy = 16 * tri.B[i];
+			const int64_t lo = e + std::min<int64_t>(dx, 0) * w + std::min<int64_t>(dy, 0) * h;
+			const int64_t hi = e + std::max<int64_t>(dx, 0) * w + std::max<int64_t>(dy, 0) * h;
+			if (hi < 0) return;
+			if (lo >= 0) continue;
+			nEdge[nEdges] = e; nStepX[nEdges] = dx; nStepY[nEdges] = dy; nEdges++;
 		}
 
-		if (vPoints.size() < 3 || vTex.size() < 3 || vColour.size() < 3)
-			return;
+		// A run of adjacent pixels can change colour by at most 256 << 16 per pixel, so
+		// clamping the steps only affects runs a single pixel long, where they are unused
+		auto step = [](int64_t d) { return int32_t(std::max<int64_t>(std::min<int64_t>(d, 1 << 28), -(1 << 28))); };
+		const int32_t dr = step(tri.nCol[0][1]), dg = step(tri.nCol[1][1]), db = step(tri.nCol[2][1]), da = step(tri.nCol[3][1]);
 
-		if (structure == olc::DecalStructure::LIST)
-		{			
-			for (int tri = 0; tri < vPoints.size() / 3; tri++)
-			{
-				std::vector<olc::vf2d> vP = { vPoints[tri * 3 + 0], vPoints[tri * 3 + 1], vPoints[tri * 3 + 2] };
-				std::vector<olc::vf2d> vT = { vTex[tri * 3 + 0], vTex[tri * 3 + 1], vTex[tri * 3 + 2] };
-				std::vector<olc::Pixel> vC = { vColour[tri * 3 + 0], vColour[tri * 3 + 1], vColour[tri * 3 + 2] };
-				FillTexturedTriangle(vP, vT, vC, sprTex);
-			}
-			return;
+		// The texture's mip chain, if it has one, is sampled at the level closest to one texel per pixel
+		const olc::Sprite* pTex = nullptr;
+		if (sprTex != nullptr)
+		{
+			const double fTexelArea = std::abs(tri.fTex[0][1] * tri.fTex[1][2] - tri.fTex[0][2] * tri.fTex[1][1]) * double(sprTex->width) * double(sprTex->height);
+			pTex = sprTex->GetMipForScale(float(std::sqrt(fTexelArea)));
 		}
 
-		if (structure == olc::DecalStructure::STRIP)
+		olc::Pixel pSpan[64], pTexel[64];
+		float fSpanU[64], fSpanV[64];
+		for (int32_t y = y0; y < y1; y++)
 		{
-			for (int tri = 2; tri < vPoints.size(); tri++)
+			// Solve each edge for where it crosses the row, the triangle is convex so what is left is one run
+			int64_t nFirst = 0, nLast = w;
+			for (int i = 0; i < nEdges && nFirst <= nLast; i++)
 			{
-				std::vector<olc::vf2d> vP = { vPoints[tri - 2], vPoints[tri-1], vPoints[tri] };
-				std::vector<olc::vf2d> vT = { vTex[tri - 2], vTex[tri - 1], vTex[tri] };
-				std::vector<olc::Pixel> vC = { vColour[tri - 2], vColour[tri - 1], vColour[tri] };
-				FillTexturedTriangle(vP, vT, vC, sprTex);
+				const int64_t e = nEdge[i] + nStepY[i] * (y - y0), dx = nStepX[i];
+				if (dx > 0) { if (e < 0) nFirst = std::max(nFirst, (-e + dx - 1) / dx); }
+				else if (e < 0) nLast = -1;
+				else if (dx < 0) nLast = std::min(nLast, e / -dx);
 			}
-			return;
-		}
+			if (nFirst > nLast) continue;
 
-		if (structure == olc::DecalStructure::FAN)
-		{
-			for (int tri = 2; tri < vPoints.size(); tri++)
+			int32_t x = x0 + int32_t(nFirst);
+			const int32_t xEnd = x0 + int32_t(nLast) + 1;
+			olc::Pixel* pDst = pDrawTarget->GetData() + size_t(y) * size_t(pDrawTarget->width) + x;
+
+			auto plane = [&](const int64_t* c) { return int32_t(std::max<int64_t>(std::min<int64_t>(c[0] + c[1] * x + c[2] * y, INT32_MAX), INT32_MIN)); };
+			int32_t r = plane(tri.nCol[0]), g = plane(tri.nCol[1]), b = plane(tri.nCol[2]), a = plane(tri.nCol[3]);
+			const double fRowU = tri.fTex[0][0] + tri.fTex[0][2] * y, fRowV = tri.fTex[1][0] + tri.fTex[1][2] * y;
+
+			while (x < xEnd)
 			{
-				std::vector<olc::vf2d> vP = { vPoints[0], vPoints[tri - 1], vPoints[tri] };
-				std::vector<olc::vf2d> vT = { vTex[0], vTex[tri - 1], vTex[tri] };
-				std::vector<olc::Pixel> vC = { vColour[0], vColour[tri - 1], vColour[tri] };
-				FillTexturedTriangle(vP, vT, vC, sprTex);
+				const int32_t n = std::min(xEnd - x, 64);
+				int32_t i = 0;
+
+				if (sprTex != nullptr)
+				{
+					// Texture coordinates are evaluated afresh for each pixel, so they do not depend on where the run starts
+					for (int32_t j = 0; j < n; j++)
+					{
+						fSpanU[j] = float(fRowU + tri.fTex[0][1] * (x + j));
+						fSpanV[j] = float(fRowV + tri.fTex[1][1] * (x + j));
+					}
+					pTex->SampleSpan(fSpanU, fSpanV, pTexel, n);
+				}
+
+#if defined(OLC_SSE2)
+				// Four pixels at a time, interpolated per channel then interleaved into RGBA
+				const __m128i mZero = _mm_setzero_si128();
+				const __m128i mOne = _mm_set1_epi16(1);
+				for (; i + 4 <= n; i += 4)
+				{
+					auto channel = [&](int32_t c, int32_t d)
+					{
+						const __m128i m = _mm_add_epi32(_mm_set1_epi32(c), _mm_set_epi32(3 * d, 2 * d, d, 0));
+						return _mm_srai_epi32(m, 16);
+					};
+					__m128i mCol = _mm_packus_epi16(
+						_mm_packs_epi32(channel(r, dr), channel(g, dg)),
+						_mm_packs_epi32(channel(b, db), channel(a, da)));
+					mCol = _mm_unpacklo_epi8(mCol, _mm_srli_si128(mCol, 8));
+					mCol = _mm_unpacklo_epi8(mCol, _mm_srli_si128(mCol, 8));
+
+					if (sprTex != nullptr)
+					{
+						const __m128i mTex = _mm_loadu_si128((const __m128i*)(pTexel + i));
+						// x / 255 == (x + 1 + (x >> 8)) >> 8 for every product of two bytes
+						auto modulate = [&](__m128i c, __m128i t)
+						{
+							const __m128i m = _mm_mullo_epi16(c, t);
+							return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(m, mOne), _mm_srli_epi16(m, 8)), 8);
+						};
+						mCol = _mm_packus_epi16(
+							modulate(_mm_unpacklo_epi8(mCol, mZero), _mm_unpacklo_epi8(mTex, mZero)),
+							modulate(_mm_unpackhi_epi8(mCol, mZero), _mm_unpackhi_epi8(mTex, mZero)));
+					}
+
+					_mm_storeu_si128((__m128i*)(pSpan + i), mCol);
+					r += 4 * dr; g += 4 * dg; b += 4 * db; a += 4 * da;
+				}
+#endif
+				for (; i < n; i++)
+				{
+					auto channel = [](int32_t c) { return uint8_t(std::max(std::min(c >> 16, 255), 0)); };
+					olc::Pixel p(channel(r), channel(g), channel(b), channel(a));
+					if (sprTex != nullptr)
+					{
+						const olc::Pixel t = pTexel[i];
+						p = olc::Pixel(uint8_t(p.r * t.r / 255), uint8_t(p.g * t.g / 255), uint8_t(p.b * t.b / 255), uint8_t(p.a * t.a / 255));
+					}
+					pSpan[i] = p;
+					r += dr; g += dg; b += db; a += da;
+				}
+
+				if (nPixelMode == Pixel::CUSTOM)
+					for (int32_t j = 0; j < n; j++) Draw(x + j, y, pSpan[j]);
+				else
+					BlendSpan(pDst, pSpan, n);
+
+				x += n; pDst += n;
 			}
-			return;
 		}
 	}
 
-
 	void PixelGameEngine::DrawSprite(const olc::vi2d& pos, Sprite* sprite, uint32_t scale, uint8_t flip)
 	{ DrawSprite(pos.x, pos.y, sprite, scale, flip); }
 
@@ -2750,6 +4833,9 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		if (BlitSprite(x, y, sprite, 0, 0, sprite->width, sprite->height, scale, flip))
+			return;
+
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
@@ -2787,6 +4873,9 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		if (BlitSprite(x, y, sprite, ox, oy, w, h, scale, flip))
+			return;
+
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = w - 1; fxm = -1; }
@@ -2816,11 +4905,402 @@ namespace olc
 		}
 	}
 
+	void PixelGameEngine::DrawTransformedSprite(const std::array<float, 6>& m, Sprite* sprite, olc::Sprite::Filter filter)
+	{
+		if (sprite == nullptr || pDrawTarget == nullptr || sprite->width <= 0 || sprite->height <= 0) return;
+
+		if (sprite == pDrawTarget)
+		{
+			std::unique_ptr<olc::Sprite> copy(sprite->Duplicate());
+			DrawTransformedSprite(m, copy.get(), filter);
+			return;
+		}
+
+		// Map back from the draw target into the sprite
+		const double det = double(m[0]) * m[4] - double(m[1]) * m[3];
+		if (det == 0.0) return;
+		const double ia = m[4] / det, ib = -m[1] / det, ic = -m[3] / det, id = m[0] / det;
+		const double ix = -(ia * m[2] + ib * m[5]), iy = -(ic * m[2] + id * m[5]);
+
+		// Bounding box of the transformed sprite, clipped to the draw target
+		const float w = float(sprite->width), h = float(sprite->height);
+		float fMinX = m[2], fMaxX = m[2], fMinY = m[5], fMaxY = m[5];
+		for (const auto& c : { olc::vf2d(w, 0.0f), olc::vf2d(0.0f, h), olc::vf2d(w, h) })
+		{
+			const float px = m[0] * c.x + m[1] * c.y + m[2], py = m[3] * c.x + m[4] * c.y + m[5];
+			fMinX = std::min(fMinX, px); fMaxX = std::max(fMaxX, px);
+			fMinY = std::min(fMinY, py); fMaxY = std::max(fMaxY, py);
+		}
+		if (!(fMinX < float(pDrawTarget->width) && fMaxX > 0.0f && fMinY < float(pDrawTarget->height) && fMaxY > 0.0f)) return;
+		const int32_t x0 = std::max(int32_t(std::floor(fMinX)), 0), x1 = std::min(int32_t(std::ceil(fMaxX)), pDrawTarget->width);
+		const int32_t y0 = std::max(int32_t(std::floor(fMinY)), 0), y1 = std::min(int32_t(std::ceil(fMaxY)), pDrawTarget->height);
+
+		// Sample coordinates are normalised, and step by a constant amount along a row.
+		// Being normalised they suit any mip level, picked by how far apart pixels land
+		const double du = ia / w, dv = ic / h;
+		const olc::Sprite* pSample = sprite->GetMipForScale(float(std::sqrt(std::abs(1.0 / det))));
+		olc::Pixel pSpan[64];
+		float fSpanU[64], fSpanV[64];
+
+		for (int32_t y = y0; y < y1; y++)
+		{
+			// Source position of the first pixel centre on the row
+			const double sx = ia * (x0 + 0.5) + ib * (y + 0.5) + ix;
+			const double sy = ic * (x0 + 0.5) + id * (y + 0.5) + iy;
+
+			// Narrow the row to the pixels whose centres land inside the sprite, which is
+			// half open like a triangle's edges: a centre exactly on the near edge is drawn
+			// and one on the far edge is not, whichever way round the transform faces.
+			// Division only gives an estimate, the ends are settled with the same sum
+			// that decides inside, so they are exact for mirrored transforms too
+			const int64_t nWidth = x1 - x0;
+			int64_t nFirst = 0, nEnd = nWidth;
+			auto limit = [&](double s, double ds, double smax)
+			{
+				auto inside = [&](int64_t t) { const double c = s + ds * double(t); return c >= 0.0 && c < smax; };
+				if (ds == 0.0) { if (!inside(0)) nEnd = 0; return; }
+				double a = -s / ds, b = (smax - s) / ds;
+				if (ds < 0.0) std::swap(a, b);
+				int64_t f = int64_t(std::ceil(std::max(std::min(a, double(nWidth)), -1.0)));
+				int64_t e = int64_t(std::ceil(std::max(std::min(b, double(nWidth)), -1.0)));
+				while (f < e && !inside(f)) f++;
+				while (f > 0 && inside(f - 1)) f--;
+				while (e > f && !inside(e - 1)) e--;
+				while (e < nWidth && inside(e)) e++;
+				nFirst = std::max(nFirst, f); nEnd = std::min(nEnd, e);
+			};
+			limit(sx, ia, double(w));
+			limit(sy, ic, double(h));
+			if (nFirst >= nEnd) continue;
+
+			int32_t x = x0 + int32_t(nFirst);
+			const int32_t xEnd = x0 + int32_t(nEnd);
+			olc::Pixel* pDst = pDrawTarget->GetData() + size_t(y) * size_t(pDrawTarget->width) + x;
+
+			// As in RasteriseTile(), coordinates are evaluated afresh for each pixel rather
+			// than accumulated, so error does not build up along long rows
+			const double fRowU = (sx - ia * x0) / w, fRowV = (sy - ic * x0) / h;
+
+			while (x < xEnd)
+			{
+				const int32_t n = std::min(xEnd - x, 64);
+				for (int32_t i = 0; i < n; i++)
+				{
+					fSpanU[i] = float(fRowU + du * (x + i));
+					fSpanV[i] = float(fRowV + dv * (x + i));
+				}
+				pSample->SampleSpan(fSpanU, fSpanV, pSpan, n, filter);
+
+				if (nPixelMode == Pixel::CUSTOM)
+					for (int32_t i = 0; i < n; i++) Draw(x + i, y, pSpan[i]);
+				else
+					BlendSpan(pDst, pSpan, n);
+
+				x += n; pDst += n;
+			}
+		}
+	}
+
+	void PixelGameEngine::DrawRotatedSprite(const olc::vf2d& pos, Sprite* sprite, const float fAngle, const olc::vf2d& center, const olc::vf2d& scale, olc::Sprite::Filter filter)
+	{
+		// Same placement as DrawRotatedDecal()
+		const float c = cos(fAngle), s = sin(fAngle);
+		DrawTransformedSprite({
+			c * scale.x, -s * scale.y, pos.x - (c * scale.x * center.x - s * scale.y * center.y),
+			s * scale.x,  c * scale.y, pos.y - (s * scale.x * center.x + c * scale.y * center.y) }, sprite, filter);
+	}
+
+	void PixelGameEngine::BlendSpan(olc::Pixel* pDst, const olc::Pixel* pSrc, int32_t nCount)
+	{
+		int32_t i = 0;
+
+		if (nPixelMode == Pixel::NORMAL)
+		{
+			std::memcpy(pDst, pSrc, nCount * sizeof(olc::Pixel));
+			return;
+		}
+
+		if (nPixelMode == Pixel::MASK)
+		{
+#if defined(OLC_SSE2)
+			const __m128i mAlpha = _mm_set1_epi32(int(0xFF000000));
+			for (; i + 4 <= nCount; i += 4)
+			{
+				const __m128i s = _mm_loadu_si128((const __m128i*)(pSrc + i));
+				const __m128i d = _mm_loadu_si128((const __m128i*)(pDst + i));
+				const __m128i m = _mm_cmpeq_epi32(_mm_and_si128(s, mAlpha), mAlpha);
+				_mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, d)));
+			}
+#endif
+			for (; i < nCount; i++)
+				if (pSrc[i].a == 255) pDst[i] = pSrc[i];
+			return;
+		}
+
+		if (nPixelMode == Pixel::ALPHA)
+		{
+			// Same arithmetic as Draw(), so results are identical to the per pixel path
+#if defined(OLC_SSE2)
+			const __m128i mAlpha = _mm_set1_epi32(int(0xFF000000));
+			const __m128i mZero = _mm_setzero_si128();
+			const __m128 mBlend = _mm_set1_ps(fBlendFactor);
+			const __m128 m255 = _mm_set1_ps(255.0f);
+			const __m128 mOne = _mm_set1_ps(1.0f);
+
+			for (; i + 4 <= nCount; i += 4)
+			{
+				const __m128i s = _mm_loadu_si128((const __m128i*)(pSrc + i));
+				const __m128i d = _mm_loadu_si128((const __m128i*)(pDst + i));
+				const int nOpaque = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, mAlpha), mAlpha));
+				const int nClear = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, mAlpha), mZero));
+
+				// Whole groups of solid or empty pixels are common, and need no arithmetic
+				if (nOpaque == 0xFFFF && fBlendFactor == 1.0f)
+				{
+					_mm_storeu_si128((__m128i*)(pDst + i), s);
+					continue;
+				}
+
+				if (nClear == 0xFFFF)
+				{
+					_mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(d, mAlpha));
+					continue;
+				}
+
+				// Alpha of all four at once, then each pixel is blended across its channels
+				const __m128 a4 = _mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(s, 24)), m255), mBlend);
+				const __m128i s01 = _mm_unpacklo_epi8(s, mZero), s23 = _mm_unpackhi_epi8(s, mZero);
+				const __m128i d01 = _mm_unpacklo_epi8(d, mZero), d23 = _mm_unpackhi_epi8(d, mZero);
+
+				auto blend = [&](__m128i s16, __m128i d16, __m128 a)
+				{
+					const __m128 c = _mm_sub_ps(mOne, a);
+					const __m128 fs = _mm_cvtepi32_ps(_mm_unpacklo_epi16(s16, mZero));
+					const __m128 fd = _mm_cvtepi32_ps(_mm_unpacklo_epi16(d16, mZero));
+					return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, fs), _mm_mul_ps(c, fd)));
+				};
+
+				const __m128i r0 = blend(s01, d01, _mm_shuffle_ps(a4, a4, _MM_SHUFFLE(0, 0, 0, 0)));
+				const __m128i r1 = blend(_mm_srli_si128(s01, 8), _mm_srli_si128(d01, 8), _mm_shuffle_ps(a4, a4, _MM_SHUFFLE(1, 1, 1, 1)));
+				const __m128i r2 = blend(s23, d23, _mm_shuffle_ps(a4, a4, _MM_SHUFFLE(2, 2, 2, 2)));
+				const __m128i r3 = blend(_mm_srli_si128(s23, 8), _mm_srli_si128(d23, 8), _mm_shuffle_ps(a4, a4, _MM_SHUFFLE(3, 3, 3, 3)));
+				const __m128i r = _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+				_mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(r, mAlpha));
+			}
+#endif
+			for (; i < nCount; i++)
+			{
+				const Pixel p = pSrc[i], d = pDst[i];
+				float a = (float)(p.a / 255.0f) * fBlendFactor;
+				float c = 1.0f - a;
+				float r = a * (float)p.r + c * (float)d.r;
+				float g = a * (float)p.g + c * (float)d.g;
+				float b = a * (float)p.b + c * (float)d.b;
+				pDst[i] = Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b);
+			}
+		}
+	}
+
+	void PixelGameEngine::FillSpan(olc::Pixel* pDst, olc::Pixel p, int32_t nNumPixels)
+	{
+		int32_t i = 0;
+
+		if (nPixelMode == Pixel::NORMAL || (nPixelMode == Pixel::MASK && p.a == 255))
+		{
+			std::fill_n(pDst, nNumPixels, p);
+			return;
+		}
+
+		if (nPixelMode == Pixel::ALPHA)
+		{
+			// Same arithmetic as Draw(), with the source half worked out once
+			const float a = (float)(p.a / 255.0f) * fBlendFactor;
+			const float c = 1.0f - a;
+#if defined(OLC_SSE2)
+			const __m128i mAlpha = _mm_set1_epi32(int(0xFF000000));
+			const __m128i mZero = _mm_setzero_si128();
+			const __m128 mC = _mm_set1_ps(c);
+			const __m128 mSrc = _mm_mul_ps(_mm_set1_ps(a), _mm_set_ps(float(p.a), float(p.b), float(p.g), float(p.r)));
+			auto blend = [&](__m128i d16)
+			{ return _mm_cvttps_epi32(_mm_add_ps(mSrc, _mm_mul_ps(mC, _mm_cvtepi32_ps(_mm_unpacklo_epi16(d16, mZero))))); };
+
+			for (; i + 4 <= nNumPixels; i += 4)
+			{
+				const __m128i d = _mm_loadu_si128((const __m128i*)(pDst + i));
+				const __m128i d01 = _mm_unpacklo_epi8(d, mZero), d23 = _mm_unpackhi_epi8(d, mZero);
+				const __m128i r = _mm_packus_epi16(
+					_mm_packs_epi32(blend(d01), blend(_mm_srli_si128(d01, 8))),
+					_mm_packs_epi32(blend(d23), blend(_mm_srli_si128(d23, 8))));
+				_mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(r, mAlpha));
+			}
+#endif
+			for (; i < nNumPixels; i++)
+			{
+				const Pixel d = pDst[i];
+				float r = a * (float)p.r + c * (float)d.r;
+				float g = a * (float)p.g + c * (float)d.g;
+				float b = a * (float)p.b + c * (float)d.b;
+				pDst[i] = Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b);
+			}
+		}
+	}
+
+	bool PixelGameEngine::BlitSprite(int32_t x, int32_t y, const olc::Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale, uint8_t flip, SpanFunc fnSpan, void* pShader)
+	{
+		if (!pDrawTarget || w <= 0 || h <= 0) return true;
+
+		// Custom modes want coordinates, and blitting a sprite onto itself
+		// must see earlier writes, so both of those take the per pixel path
+		if (fnSpan == nullptr && (nPixelMode == Pixel::CUSTOM || sprite == pDrawTarget)) return false;
+
+		// A shader gets the source as it was before any of it was drawn over
+		if (sprite == pDrawTarget)
+		{
+			olc::Sprite copy(w, h);
+			for (int32_t j = 0; j < copy.height; j++)
+				for (int32_t i = 0; i < copy.width; i++)
+					copy.pColData[size_t(j) * copy.width + i] = sprite->GetPixel(ox + i, oy + j);
+			return BlitSprite(x, y, &copy, 0, 0, w, h, scale, flip, fnSpan, pShader);
+		}
+
+		const int32_t s = std::max(int32_t(scale), 1);
+		const int32_t x0 = std::max(x, 0), y0 = std::max(y, 0);
+		const int32_t x1 = std::min(x + w * s, pDrawTarget->width), y1 = std::min(y + h * s, pDrawTarget->height);
+		if (x0 >= x1 || y0 >= y1) return true;
+
+		const bool bFlipH = (flip & olc::Sprite::Flip::HORIZ) != 0;
+		const bool bFlipV = (flip & olc::Sprite::Flip::VERT) != 0;
+		const int32_t nSpan = x1 - x0;
+
+		// Wrapped sampling and regions outside the sprite are fetched through GetPixel()
+		const bool bInside = sprite->modeSample == olc::Sprite::Mode::NORMAL && !sprite->pColData.empty() && ox >= 0 && oy >= 0 && ox + w <= sprite->width && oy + h <= sprite->height;
+
+		// Unscaled, unflipped rows can be read straight out of the sprite, otherwise
+		// each source row is flipped or expanded once and reused for every row it covers
+		const bool bDirect = s == 1 && !bFlipH && bInside;
+		if (!bDirect && vBlitSpan.size() < size_t(nSpan)) vBlitSpan.resize(nSpan);
+
+		int32_t nExpandedRow = -1;
+		for (int32_t dy = y0; dy < y1; dy++)
+		{
+			const int32_t j = (dy - y) / s;
+			const int32_t sy = oy + (bFlipV ? h - 1 - j : j);
+			const olc::Pixel* pRow = bInside ? sprite->pColData.data() + size_t(sy) * sprite->width + ox : nullptr;
+			const olc::Pixel* pSpan = vBlitSpan.data();
+
+			if (bDirect)
+				pSpan = pRow + (x0 - x);
+			else
+			{
+				if (j != nExpandedRow && s == 1 && bInside)
+				{
+					const olc::Pixel* pIn = pRow + (w - 1 - (x0 - x));
+					for (int32_t i = 0; i < nSpan; i++) vBlitSpan[i] = pIn[-i];
+					nExpandedRow = j;
+				}
+				else if (j != nExpandedRow)
+				{
+					olc::Pixel* pOut = vBlitSpan.data();
+					int32_t i = (x0 - x) / s, r = s - (x0 - x) % s, n = nSpan;
+					while (n > 0)
+					{
+						const int32_t c = std::min(r, n);
+						const int32_t sx = bFlipH ? w - 1 - i : i;
+						std::fill_n(pOut, c, bInside ? pRow[sx] : sprite->GetPixel(ox + sx, sy));
+						pOut += c; n -= c; r = s; i++;
+					}
+					nExpandedRow = j;
+				}
+			}
+
+			olc::Pixel* pDst = pDrawTarget->pColData.data() + size_t(dy) * pDrawTarget->width + x0;
+			if (fnSpan != nullptr)
+				fnSpan(pShader, pSpan, pDst, nSpan);
+			else
+				BlendSpan(pDst, pSpan, nSpan);
+		}
+		return true;
+	}
+
+	void PixelGameEngine::FillRectSpans(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p, SpanFunc fnSpan, void* pShader)
+	{
+		if (!pDrawTarget) return;
+
+		const int32_t x0 = std::max(x, 0), y0 = std::max(y, 0);
+		const int32_t x1 = std::min(x + w, pDrawTarget->width), y1 = std::min(y + h, pDrawTarget->height);
+		if (x0 >= x1 || y0 >= y1) return;
+
+		const int32_t nSpan = x1 - x0;
+		if (vBlitSpan.size() < size_t(nSpan)) vBlitSpan.resize(nSpan);
+		std::fill_n(vBlitSpan.data(), nSpan, p);
+
+		for (int32_t dy = y0; dy < y1; dy++)
+			fnSpan(pShader, vBlitSpan.data(), pDrawTarget->pColData.data() + size_t(dy) * pDrawTarget->width + x0, nSpan);
+	}
+
+	void DecalCommandBuffer::Begin(uint8_t layer)
+	{
+		// One buffer records per thread at a time, End() the previous one first
+		assert(pDecalRecording == nullptr || pDecalRecording == this);
+		nLayer = layer;
+		nMode = olc::DecalMode::NORMAL;
+		nStructure = olc::DecalStructure::FAN;
+		pDecalRecording = this;
+	}
+
+	void DecalCommandBuffer::End()
+	{ if (pDecalRecording == this) pDecalRecording = nullptr; }
+
+	void DecalCommandBuffer::SetLayer(uint8_t layer)
+	{ nLayer = layer; }
+
+	void DecalCommandBuffer::Clear()
+	{ vCommands.clear(); }
+
+	bool DecalCommandBuffer::IsEmpty() const
+	{ return vCommands.empty(); }
+
+	olc::DecalMode& PixelGameEngine::olc_DecalMode()
+	{
+		assert(pDecalRecording != nullptr || std::this_thread::get_id() == idUpdateThread);
+		return pDecalRecording ? pDecalRecording->nMode : nDecalMode;
+	}
+
+	olc::DecalStructure& PixelGameEngine::olc_DecalStructure()
+	{
+		assert(pDecalRecording != nullptr || std::this_thread::get_id() == idUpdateThread);
+		return pDecalRecording ? pDecalRecording->nStructure : nDecalStructure;
+	}
+
+	void PixelGameEngine::olc_PushDecal(olc::DecalInstance&& di)
+	{
+		// Only the update thread may add to the layers, jobs record into a DecalCommandBuffer
+		assert(pDecalRecording != nullptr || std::this_thread::get_id() == idUpdateThread);
+		if (pDecalRecording)
+			pDecalRecording->vCommands.emplace_back(pDecalRecording->nLayer, std::move(di));
+		else
+			vLayers[nTargetLayer].vecDecalInstance.push_back(std::move(di));
+	}
+
 	void PixelGameEngine::SetDecalMode(const olc::DecalMode& mode)
-	{ nDecalMode = mode; }
+	{ olc_DecalMode() = mode; }
 
 	void PixelGameEngine::SetDecalStructure(const olc::DecalStructure& structure)
-	{ nDecalStructure = structure; }
+	{ olc_DecalStructure() = structure; }
+
+	void PixelGameEngine::SubmitDecalCommands(olc::DecalCommandBuffer& buffer)
+	{
+		// Moved across whole, the buffer keeps its capacity for next time
+		for (auto& cmd : buffer.vCommands)
+			if (cmd.first < vLayers.size())
+				vLayers[cmd.first].vecDecalInstance.push_back(std::move(cmd.second));
+		buffer.vCommands.clear();
+	}
+
+	void PixelGameEngine::SubmitDecalCommands(std::vector<olc::DecalCommandBuffer>& vBuffers)
+	{
+		for (auto& buffer : vBuffers) SubmitDecalCommands(buffer);
+	}
 
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale, const olc::Pixel& tint)
 	{
@@ -2850,9 +5330,9 @@ namespace olc
 		olc::vf2d uvbr = (source_pos + source_size - olc::vf2d(0.0001f, 0.0001f)) * decal->vUVScale;
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.w = { 1,1,1,1 };
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -2878,9 +5358,9 @@ namespace olc
 		olc::vf2d uvbr = uvtl + ((source_size) * decal->vUVScale);
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.w = { 1,1,1,1 };
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 
@@ -2905,9 +5385,9 @@ namespace olc
 		di.pos = { { vScreenSpacePos.x, vScreenSpacePos.y }, { vScreenSpacePos.x, vScreenSpaceDim.y }, { vScreenSpaceDim.x, vScreenSpaceDim.y }, { vScreenSpaceDim.x, vScreenSpacePos.y } };
 		di.uv = { { 0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f} };
 		di.w = { 1, 1, 1, 1 };
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawExplicitDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, const olc::Pixel* col, uint32_t elements)
@@ -2926,9 +5406,9 @@ namespace olc
 			di.tint[i] = col[i];
 			di.w[i] = 1.0f;
 		}
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const olc::Pixel tint)
@@ -2947,9 +5427,9 @@ namespace olc
 			di.tint[i] = tint;
 			di.w[i] = 1.0f;
 		}
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel> &tint)
@@ -2968,9 +5448,9 @@ namespace olc
 			di.tint[i] = tint[i];
 			di.w[i] = 1.0f;
 		}
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const std::vector<olc::Pixel>& colours, const olc::Pixel tint)
@@ -2998,9 +5478,9 @@ namespace olc
 			di.tint[i] = tint;
 			di.w[i] = 1.0f;
 		}
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 #ifdef OLC_ENABLE_EXPERIMENTAL
@@ -3022,16 +5502,17 @@ namespace olc
 			di.tint[i] = col[i];			
 		}
 		di.mode = DecalMode::MODEL3D;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_PushDecal(std::move(di));
 	}
 #endif
 
 	void PixelGameEngine::DrawLineDecal(const olc::vf2d& pos1, const olc::vf2d& pos2, Pixel p)
 	{
-		auto m = nDecalMode;
-		nDecalMode = olc::DecalMode::WIREFRAME;
+		olc::DecalMode& mode = olc_DecalMode();
+		auto m = mode;
+		mode = olc::DecalMode::WIREFRAME;
 		DrawPolygonDecal(nullptr, { pos1, pos2 }, { {0, 0}, {0,0} }, p);
-		nDecalMode = m;
+		mode = m;
 
 		/*DecalInstance di;
 		di.decal = nullptr;
@@ -3055,7 +5536,7 @@ namespace olc
 
 	void PixelGameEngine::DrawRectDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::Pixel col)
 	{
-		auto m = nDecalMode;
+		auto m = olc_DecalMode();
 		SetDecalMode(olc::DecalMode::WIREFRAME);
 		olc::vf2d vNewSize = size;// (size - olc::vf2d(0.375f, 0.375f)).ceil();
 		std::array<olc::vf2d, 4> points = { { {pos}, {pos.x, pos.y + vNewSize.y}, {pos + vNewSize}, {pos.x + vNewSize.x, pos.y} } };
@@ -3104,9 +5585,9 @@ namespace olc
 			di.pos[i].y *= -1.0f;
 			di.w[i] = 1;
 		}
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 
@@ -3133,9 +5614,9 @@ namespace olc
 		olc::vf2d uvtl = source_pos * decal->vUVScale;
 		olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
-		di.mode = nDecalMode;
-		di.structure = nDecalStructure;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		di.mode = olc_DecalMode();
+		di.structure = olc_DecalStructure();
+		olc_PushDecal(std::move(di));
 	}
 
 	void PixelGameEngine::DrawPartialWarpedDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -3166,9 +5647,9 @@ namespace olc
 				di.uv[i] *= q; di.w[i] *= q;
 				di.pos[i] = { (pos[i].x * vInvScreenSize.x) * 2.0f - 1.0f, ((pos[i].y * vInvScreenSize.y) * 2.0f - 1.0f) * -1.0f };
 			}
-			di.mode = nDecalMode;
-			di.structure = nDecalStructure;
-			vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+			di.mode = olc_DecalMode();
+			di.structure = olc_DecalStructure();
+			olc_PushDecal(std::move(di));
 		}
 	}
 
@@ -3198,9 +5679,9 @@ namespace olc
 				di.uv[i] *= q; di.w[i] *= q;
 				di.pos[i] = { (pos[i].x * vInvScreenSize.x) * 2.0f - 1.0f, ((pos[i].y * vInvScreenSize.y) * 2.0f - 1.0f) * -1.0f };
 			}
-			di.mode = nDecalMode;
-			di.structure = nDecalStructure;
-			vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+			di.mode = olc_DecalMode();
+			di.structure = olc_DecalStructure();
+			olc_PushDecal(std::move(di));
 		}
 	}
 
@@ -3349,31 +5830,64 @@ namespace olc
 			}
 			else			
 			{
-				int32_t ox = (c - 32) % 16;
-				int32_t oy = (c - 32) / 16;
-
-				if (scale > 1)
-				{
-					for (uint32_t i = 0; i < 8; i++)
-						for (uint32_t j = 0; j < 8; j++)
-							if (fontRenderable.Sprite()->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-								for (uint32_t is = 0; is < scale; is++)
-									for (uint32_t js = 0; js < scale; js++)
-										Draw(x + sx + (i * scale) + is, y + sy + (j * scale) + js, col);
-				}
-				else
-				{
-					for (uint32_t i = 0; i < 8; i++)
-						for (uint32_t j = 0; j < 8; j++)
-							if (fontRenderable.Sprite()->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-								Draw(x + sx + i, y + sy + j, col);
-				}
+				if (c >= 32 && c - 32 < int(fontSheet.masks.size()))
+					DrawGlyph(x + sx, y + sy, fontSheet.masks[c - 32], 0, 8, col, scale);
 				sx += 8 * scale;
 			}
 		}
 		SetPixelMode(m);
 	}
 
+	void PixelGameEngine::DrawGlyph(int32_t x, int32_t y, uint64_t nMask, int32_t nFirst, int32_t nWidth, Pixel col, uint32_t scale)
+	{
+		if (!pDrawTarget) return;
+		const int32_t s = std::max(int32_t(scale), 1);
+
+		// Custom pixel modes need every pixel visiting in turn
+		if (nPixelMode == Pixel::CUSTOM)
+		{
+			for (int32_t i = 0; i < nWidth; i++)
+				for (int32_t j = 0; j < 8; j++)
+					if ((nMask >> (j * 8 + nFirst + i)) & 1)
+						for (int32_t is = 0; is < s; is++)
+							for (int32_t js = 0; js < s; js++)
+								Draw(x + i * s + is, y + j * s + js, col);
+			return;
+		}
+
+		const uint32_t nColumns = (1u << nWidth) - 1;
+		const bool bSolid = nPixelMode == Pixel::NORMAL || (nPixelMode == Pixel::MASK && col.a == 255);
+		if (bSolid && s == 1 && x >= 0 && y >= 0 && x + nWidth <= pDrawTarget->width && y + 8 <= pDrawTarget->height)
+		{
+			// Unscaled and fully visible, which is most console text, so just poke the pixels
+			olc::Pixel* pRow = pDrawTarget->pColData.data() + size_t(y) * pDrawTarget->width + x;
+			for (int32_t j = 0; j < 8; j++, pRow += pDrawTarget->width)
+				for (uint32_t nRow = uint32_t(nMask >> (j * 8 + nFirst)) & nColumns, i = 0; nRow; nRow >>= 1, i++)
+					if (nRow & 1) pRow[i] = col;
+			return;
+		}
+
+		for (int32_t j = 0; j < 8; j++)
+		{
+			const uint32_t nRow = uint32_t(nMask >> (j * 8 + nFirst)) & nColumns;
+			if (nRow == 0) continue;
+
+			const int32_t y0 = std::max(y + j * s, 0), y1 = std::min(y + (j + 1) * s, pDrawTarget->height);
+			for (int32_t i = 0; i < nWidth;)
+			{
+				if (!((nRow >> i) & 1)) { i++; continue; }
+
+				// Each run of lit pixels is one span, repeated for each scaled row
+				int32_t e = i;
+				while (e < nWidth && ((nRow >> e) & 1)) e++;
+				const int32_t x0 = std::max(x + i * s, 0), x1 = std::min(x + e * s, pDrawTarget->width);
+				for (int32_t py = y0; x0 < x1 && py < y1; py++)
+					FillSpan(pDrawTarget->pColData.data() + size_t(py) * pDrawTarget->width + x0, col, x1 - x0);
+				i = e;
+			}
+		}
+	}
+
 	olc::vi2d PixelGameEngine::GetTextSizeProp(const std::string& s)
 	{
 		olc::vi2d size = { 0,1 };
@@ -3415,28 +5929,11 @@ namespace olc
 			{
 				sx += 8 * nTabSizeInSpaces * scale;
 			}
-			else
+			else if (c >= 32 && c - 32 < int(fontSheet.masks.size()))
 			{
-				int32_t ox = (c - 32) % 16;
-				int32_t oy = (c - 32) / 16;
-
-				if (scale > 1)
-				{
-					for (int32_t i = 0; i < vFontSpacing[c - 32].y; i++)
-						for (int32_t j = 0; j < 8; j++)
-							if (fontRenderable.Sprite()->GetPixel(i + ox * 8 + vFontSpacing[c - 32].x, j + oy * 8).r > 0)
-								for (int32_t is = 0; is < int(scale); is++)
-									for (int32_t js = 0; js < int(scale); js++)
-										Draw(x + sx + (i * scale) + is, y + sy + (j * scale) + js, col);
-				}
-				else
-				{
-					for (int32_t i = 0; i < vFontSpacing[c - 32].y; i++)
-						for (int32_t j = 0; j < 8; j++)
-							if (fontRenderable.Sprite()->GetPixel(i + ox * 8 + vFontSpacing[c - 32].x, j + oy * 8).r > 0)
-								Draw(x + sx + i, y + sy + j, col);
-				}
-				sx += vFontSpacing[c - 32].y * scale;
+				const olc::vi2d& spacing = vFontSpacing[c - 32];
+				DrawGlyph(x + sx, y + sy, fontSheet.masks[c - 32], spacing.x, spacing.y, col, scale);
+				sx += spacing.y * scale;
 			}
 		}
 		SetPixelMode(m);
@@ -3588,6 +6085,67 @@ namespace olc
 	{ return bTextEntryEnable; }
 
 
+	std::future<std::unique_ptr<olc::Decal>> PixelGameEngine::QueueDecalCreate(olc::Sprite* spr, bool filter, bool clamp)
+	{
+		auto task = std::make_shared<std::packaged_task<std::unique_ptr<olc::Decal>()>>([spr, filter, clamp]()
+		{ return std::make_unique<olc::Decal>(spr, filter, clamp); });
+		QueueGPUTask([task]() { (*task)(); }, spr ? spr->pColData.size() * sizeof(olc::Pixel) : 0);
+		return task->get_future();
+	}
+
+	std::future<void> PixelGameEngine::QueueDecalUpdate(olc::Decal* decal)
+	{
+		size_t nBytes = (decal && decal->sprite) ? decal->sprite->pColData.size() * sizeof(olc::Pixel) : 0;
+		return QueueGPUTask([decal]() { if (decal) decal->Update(); }, nBytes);
+	}
+
+	std::future<void> PixelGameEngine::QueueDecalDestroy(std::unique_ptr<olc::Decal> decal)
+	{
+		// std::function must be copyable, so the decal is shared until the task runs
+		std::shared_ptr<olc::Decal> pDecal(std::move(decal));
+		return QueueGPUTask([pDecal]() mutable { pDecal.reset(); });
+	}
+
+	std::future<void> PixelGameEngine::QueueGPUTask(std::function<void()> func, size_t nUploadBytes)
+	{
+		auto task = std::make_shared<std::packaged_task<void()>>(std::move(func));
+		std::future<void> f = task->get_future();
+		std::scoped_lock<std::mutex> lock(muxGPUTasks);
+		qGPUTasks.push_back({ nUploadBytes, [task]() { (*task)(); } });
+		return f;
+	}
+
+	void PixelGameEngine::SetGPUUploadBudget(const size_t nBytesPerFrame)
+	{ nGPUUploadBudget = nBytesPerFrame; }
+
+	void PixelGameEngine::ProcessGPUTasks()
+	{
+		// Only what was queued before this frame runs, a task that queues more work
+		// (a retry or a continuation) has it picked up next frame instead of spinning here
+		size_t nTasks = 0;
+		{
+			std::scoped_lock<std::mutex> lock(muxGPUTasks);
+			nTasks = qGPUTasks.size();
+		}
+
+		size_t nUploaded = 0;
+		for (; nTasks > 0; nTasks--)
+		{
+			GPUTask task;
+			{
+				std::scoped_lock<std::mutex> lock(muxGPUTasks);
+				if (qGPUTasks.empty()) break;
+				// Always let one task through, so a single large upload cannot block the queue
+				if (nGPUUploadBudget > 0 && nUploaded > 0 && nUploaded + qGPUTasks.front().nBytes > nGPUUploadBudget) break;
+				task = std::move(qGPUTasks.front());
+				qGPUTasks.pop_front();
+			}
+			// Executed outside of lock, the task itself may queue more work
+			task.func();
+			nUploaded += task.nBytes;
+		}
+	}
+
 	void PixelGameEngine::UpdateTextEntry()
 	{
 		// Check for typed characters
@@ -3715,7 +6273,7 @@ namespace olc
 	}
 
 	void PixelGameEngine::olc_UpdateMouseWheel(int32_t delta)
-	{ nMouseWheelDeltaCache += delta; }
+	{ olc_PushInput(olc::InputEvent::Type::MOUSE_WHEEL, delta); }
 
 	void PixelGameEngine::olc_UpdateMouse(int32_t x, int32_t y)
 	{
@@ -3732,13 +6290,118 @@ namespace olc
 		if (vMousePosCache.y >= (int32_t)vScreenSize.y)	vMousePosCache.y = vScreenSize.y - 1;
 		if (vMousePosCache.x < 0) vMousePosCache.x = 0;
 		if (vMousePosCache.y < 0) vMousePosCache.y = 0;
+		olc_PushInput(olc::InputEvent::Type::MOUSE_MOVE, 0);
 	}
 
 	void PixelGameEngine::olc_UpdateMouseState(int32_t button, bool state)
-	{ pMouseNewState[button] = state; }
+	{
+		// Only changes are queued, repeats while held are not
+		if (pMouseNewState[button].load(std::memory_order_relaxed) == state) return;
+		pMouseNewState[button].store(state, std::memory_order_relaxed);
+		olc_PushInput(state ? olc::InputEvent::Type::MOUSE_DOWN : olc::InputEvent::Type::MOUSE_UP, button);
+	}
 
 	void PixelGameEngine::olc_UpdateKeyState(int32_t key, bool state)
-	{ pKeyNewState[key] = state; }
+	{
+		if (pKeyNewState[key].load(std::memory_order_relaxed) == state) return;
+		pKeyNewState[key].store(state, std::memory_order_relaxed);
+		olc_PushInput(state ? olc::InputEvent::Type::KEY_DOWN : olc::InputEvent::Type::KEY_UP, key);
+	}
+
+	void PixelGameEngine::olc_PushInput(olc::InputEvent::Type type, int32_t nCode)
+	{
+		olc::InputEvent e;
+		e.type = type;
+		e.nCode = nCode;
+		e.vPos = vMousePosCache;
+		e.nTime = Profiler::Now();
+		pInputRing->Push(e);
+	}
+
+	void PixelGameEngine::olc_ProcessInput()
+	{
+		// Only the buttons that changed last frame have edges to clear
+		for (const auto& e : vInputEvents)
+		{
+			if (e.type == olc::InputEvent::Type::KEY_DOWN || e.type == olc::InputEvent::Type::KEY_UP)
+				pKeyboardState[e.nCode].bPressed = pKeyboardState[e.nCode].bReleased = false;
+			else if (e.type == olc::InputEvent::Type::MOUSE_DOWN || e.type == olc::InputEvent::Type::MOUSE_UP)
+				pMouseState[e.nCode].bPressed = pMouseState[e.nCode].bReleased = false;
+		}
+		vInputEvents.clear();
+		nMouseWheelDelta = 0;
+
+		auto Apply = [](HWButton& button, bool& bOld, bool bDown)
+		{
+			if (bDown)
+			{
+				button.bPressed |= !button.bHeld;
+				button.bHeld = true;
+			}
+			else
+			{
+				button.bReleased |= button.bHeld;
+				button.bHeld = false;
+			}
+			bOld = bDown;
+		};
+
+		// Counted before draining, so every event queued ahead of those drops is delivered first
+		const uint32_t nDropped = pInputRing->nDropped.load(std::memory_order_relaxed);
+
+		olc::InputEvent e;
+		e.vPos = vMousePos;
+		e.nTime = nInputLastTime;
+		while (pInputRing->Pop(e))
+		{
+			switch (e.type)
+			{
+			case olc::InputEvent::Type::KEY_DOWN:    Apply(pKeyboardState[e.nCode], pKeyOldState[e.nCode], true); break;
+			case olc::InputEvent::Type::KEY_UP:      Apply(pKeyboardState[e.nCode], pKeyOldState[e.nCode], false); break;
+			case olc::InputEvent::Type::MOUSE_DOWN:  Apply(pMouseState[e.nCode], pMouseOldState[e.nCode], true); break;
+			case olc::InputEvent::Type::MOUSE_UP:    Apply(pMouseState[e.nCode], pMouseOldState[e.nCode], false); break;
+			case olc::InputEvent::Type::MOUSE_WHEEL: nMouseWheelDelta += e.nCode; break;
+			default: break;
+			}
+			if (e.type == olc::InputEvent::Type::KEY_DOWN || e.type == olc::InputEvent::Type::MOUSE_DOWN)
+				LatencyTracker::MarkResponse(e.nTime, "Input");
+			vInputEvents.push_back(e);
+		}
+
+		// Every event carries the position, so the platform's own copy is never read here
+		vMousePos = e.vPos;
+		nInputLastTime = e.nTime;
+
+		// The ring overflowed, so catch up with whatever state the platform last reported,
+		// standing in events for the changes that were lost. The platform may be reporting
+		// more as this runs, so each button is read once, and changes whose events are still
+		// queued are applied again when they arrive, which leaves no extra edges. The stand
+		// ins take the time of the last event delivered, so times never go backwards
+		if (nDropped != nInputDropped)
+		{
+			nInputDropped = nDropped;
+			const uint64_t nPos = pInputRing->nLastPos.load(std::memory_order_relaxed);
+			vMousePos = e.vPos = { int32_t(uint32_t(nPos >> 32)), int32_t(uint32_t(nPos)) };
+			for (int32_t i = 0; i < 256; i++)
+			{
+				const bool bDown = pKeyNewState[i].load(std::memory_order_relaxed);
+				if (bDown == pKeyOldState[i]) continue;
+				Apply(pKeyboardState[i], pKeyOldState[i], bDown);
+				e.type = bDown ? olc::InputEvent::Type::KEY_DOWN : olc::InputEvent::Type::KEY_UP;
+				e.nCode = i;
+				vInputEvents.push_back(e);
+			}
+			for (int32_t i = 0; i < int32_t(nMouseButtons); i++)
+			{
+				const bool bDown = pMouseNewState[i].load(std::memory_order_relaxed);
+				if (bDown == pMouseOldState[i]) continue;
+				Apply(pMouseState[i], pMouseOldState[i], bDown);
+				e.type = bDown ? olc::InputEvent::Type::MOUSE_DOWN : olc::InputEvent::Type::MOUSE_UP;
+				e.nCode = i;
+				vInputEvents.push_back(e);
+			}
+		}
+	}
 
 	void PixelGameEngine::olc_UpdateMouseFocus(bool state)
 	{ bHasMouseFocus = state; }
@@ -3785,7 +6448,10 @@ namespace olc
 		while (bAtomActive)
 		{
 			// Run as fast as possible
-			while (bAtomActive) { olc_CoreUpdate(); }
+			if (bPipelinedRendering)
+				olc_PipelinedLoop();
+			else
+				while (bAtomActive) { olc_CoreUpdate(); }
 
 			// Allow the user to free resources if they have overrided the destroy function
 			if (!OnUserDestroy())
@@ -3795,11 +6461,15 @@ namespace olc
 			}
 		}
 
+		// Nothing should still be running once the application has cleaned up
+		jobs.Stop();
 		platform->ThreadCleanUp();
 	}
 
 	void PixelGameEngine::olc_PrepareEngine()
 	{
+		idUpdateThread = std::this_thread::get_id();
+
 		// Start OpenGL, the context is owned by the game thread
 		if (platform->CreateGraphics(bFullScreen, bEnableVSYNC, vViewPos, vViewSize) == olc::FAIL) return;
 
@@ -3812,63 +6482,128 @@ namespace olc
 		vLayers[0].bShow = true;
 		SetDrawTarget(nullptr);
 
-		m_tp1 = std::chrono::system_clock::now();
-		m_tp2 = std::chrono::system_clock::now();
+		m_tp1 = std::chrono::steady_clock::now();
+		m_tp2 = std::chrono::steady_clock::now();
+		tpFrameStart = m_tp1;
+	}
+
+	void PixelGameEngine::olc_PaceFrame()
+	{
+#if !defined(OLC_PLATFORM_EMSCRIPTEN)
+		// The browser already schedules frames with the display
+		using namespace std::chrono;
+		const bool bIdle = fIdleFrameRate > 0.0f && bSceneStatic && vInputEvents.empty();
+		const float fRate = bIdle ? fIdleFrameRate : fFrameRateLimit;
+		if (fRate <= 0.0f)
+		{
+			tpFrameStart = steady_clock::now();
+			return;
+		}
+
+		// Frames start a whole period after the previous one was due, so lateness in one
+		// frame is made up in the next rather than adding up. A frame so late that it has
+		// missed the next start as well sets a new schedule instead of bursting to catch up
+		const auto period = duration_cast<steady_clock::duration>(duration<double>(1.0 / double(fRate)));
+		tpFrameStart += period;
+		auto now = steady_clock::now();
+		if (now - tpFrameStart > period) tpFrameStart = now;
+
+		while (now < tpFrameStart)
+		{
+			if (bIdle)
+			{
+				// Some platforms only read their events when asked
+				platform->HandleSystemEvent();
+				if (!bAtomActive || pInputRing->nHead.load(std::memory_order_acquire) != pInputRing->nTail.load(std::memory_order_relaxed))
+				{
+					tpFrameStart = now;
+					break;
+				}
+			}
+
+			const auto remaining = tpFrameStart - now;
+			if (remaining > durSleepOvershoot)
+			{
+				// Sleep short of the deadline by as much as sleeps have recently overrun,
+				// and in small steps when idle so input is noticed promptly
+				auto slice = remaining - durSleepOvershoot;
+				if (bIdle) slice = std::min<steady_clock::duration>(slice, milliseconds(4));
+				std::this_thread::sleep_for(slice);
+				const auto after = steady_clock::now();
+				const auto overrun = (after - now) - slice;
+				if (overrun > durSleepOvershoot) durSleepOvershoot = overrun;
+				else durSleepOvershoot -= (durSleepOvershoot - overrun) / 16;
+				now = after;
+			}
+			else
+			{
+				std::this_thread::yield();
+				now = steady_clock::now();
+			}
+		}
+#endif
 	}
 
 
 	void PixelGameEngine::olc_CoreUpdate()
 	{
+		// Waiting for the frame to be due is not part of it
+		olc_PaceFrame();
+
+		olc::ProfileZone zoneFrame("Frame");
+		const uint64_t nUploadStart = nTextureUploadBytes.load(std::memory_order_relaxed);
+		const uint64_t nPixelAllocStart = PixelPool::GetAllocationCount();
+		const uint64_t nHeapAllocStart = nHeapAllocations.load(std::memory_order_relaxed);
+
 		// Handle Timing
-		m_tp2 = std::chrono::system_clock::now();
+		m_tp2 = std::chrono::steady_clock::now();
 		std::chrono::duration<float> elapsedTime = m_tp2 - m_tp1;
 		m_tp1 = m_tp2;
 
 		// Our time per frame coefficient
 		float fElapsedTime = elapsedTime.count();
+		const float fFrameTime = fElapsedTime;
+		if (bFrameTimeSmoothing)
+		{
+			// A frame far from the average means the rate has really changed, so follow it
+			if (fElapsedTime > fFrameTimeAverage * 2.0f || fElapsedTime < fFrameTimeAverage * 0.5f)
+			{
+				fFrameTimeAverage = fElapsedTime;
+				fFrameTimeDebt = 0.0f;
+			}
+			else
+			{
+				fFrameTimeAverage += (fElapsedTime - fFrameTimeAverage) * 0.1f;
+				const float fSmoothed = std::max(0.0f, fFrameTimeAverage + fFrameTimeDebt * 0.25f);
+				fFrameTimeDebt += fElapsedTime - fSmoothed;
+				fElapsedTime = fSmoothed;
+			}
+		}
 		fLastElapsed = fElapsedTime;
 
 		if (bConsoleSuspendTime)
 			fElapsedTime = 0.0f;
 
-		// Some platforms will need to check for events
-		platform->HandleSystemEvent();
-
-		// Compare hardware input states from previous frame
-		auto ScanHardware = [&](HWButton* pKeys, bool* pStateOld, bool* pStateNew, uint32_t nKeyCount)
 		{
-			for (uint32_t i = 0; i < nKeyCount; i++)
-			{
-				pKeys[i].bPressed = false;
-				pKeys[i].bReleased = false;
-				if (pStateNew[i] != pStateOld[i])
-				{
-					if (pStateNew[i])
-					{
-						pKeys[i].bPressed = !pKeys[i].bHeld;
-						pKeys[i].bHeld = true;
-					}
-					else
-					{
-						pKeys[i].bReleased = true;
-						pKeys[i].bHeld = false;
-					}
-				}
-				pStateOld[i] = pStateNew[i];
-			}
-		};
+			olc::ProfileZone zone("Input");
 
-		ScanHardware(pKeyboardState, pKeyOldState, pKeyNewState, 256);
-		ScanHardware(pMouseState, pMouseOldState, pMouseNewState, nMouseButtons);
+			// Some platforms will need to check for events
+			platform->HandleSystemEvent();
 
-		// Cache mouse coordinates so they remain consistent during frame
-		vMousePos = vMousePosCache;
-		nMouseWheelDelta = nMouseWheelDeltaCache;
-		nMouseWheelDeltaCache = 0;
+			// Apply everything the platform has reported since last frame, in order,
+			// which also takes the mouse position so it remains consistent during frame
+			olc_ProcessInput();
 
-		vDroppedFiles = vDroppedFilesCache;
-		vDroppedFilesPoint = vDroppedFilesPointCache;
-		vDroppedFilesCache.clear();
+			vDroppedFiles = vDroppedFilesCache;
+			vDroppedFilesPoint = vDroppedFilesPointCache;
+			vDroppedFilesCache.clear();
+		}
+
+		// Service GPU work requested by other threads, results are visible to this frame
+		{
+			olc::ProfileZone zone("GPU Tasks");
+			ProcessGPUTasks();
+		}
 
 		if (bTextEntryEnable)
 		{
@@ -3877,128 +6612,263 @@ namespace olc
 
 		// Handle Frame Update
 		bool bExtensionBlockFrame = false;		
-		for (auto& ext : vExtensions) bExtensionBlockFrame |= ext->OnBeforeUserUpdate(fElapsedTime);
+		{
+			olc::ProfileZone zone("OnBeforeUserUpdate");
+			for (auto& ext : vExtensions) bExtensionBlockFrame |= ext->OnBeforeUserUpdate(fElapsedTime);
+		}
 		if (!bExtensionBlockFrame)
 		{
+			olc::ProfileZone zone("OnUserUpdate");
 			if (!OnUserUpdate(fElapsedTime)) bAtomActive = false;
 			
 		}
-		for (auto& ext : vExtensions) ext->OnAfterUserUpdate(fElapsedTime);
+		{
+			olc::ProfileZone zone("OnAfterUserUpdate");
+			for (auto& ext : vExtensions) ext->OnAfterUserUpdate(fElapsedTime);
+		}
 
 		if (bConsoleShow)
 		{
+			olc::ProfileZone zone("Console");
 			SetDrawTarget((uint8_t)0);
 			UpdateConsole();
 		}
 
 		
 
-		// Display Frame
-		renderer->UpdateViewport(vViewPos, vViewSize);
-		renderer->ClearBuffer(olc::BLACK, true);
+		// Display Frame, here or on the render thread
+		olc_SubmitFrame();
+
+		statsFrame.fFrameTime = fFrameTime;
+		statsFrame.nUploadBytes = nTextureUploadBytes.load(std::memory_order_relaxed) - nUploadStart;
+		statsFrame.nPixelAllocations = uint32_t(PixelPool::GetAllocationCount() - nPixelAllocStart);
+		statsFrame.nHeapAllocations = uint32_t(nHeapAllocations.load(std::memory_order_relaxed) - nHeapAllocStart);
+
+		// Update Title Bar
+		fFrameTimer += fElapsedTime;
+		nFrameCount++;
+		if (fFrameTimer >= 1.0f)
+		{
+			nLastFPS = nFrameCount;
+			fFrameTimer -= 1.0f;
+			std::string sTitle = "OneLoneCoder.com - Pixel Game Engine - " + sAppName + " - FPS: " + std::to_string(nFrameCount);
+			platform->SetWindowTitle(sTitle);
+			nFrameCount = 0;
+		}
+	}
+
+	void PixelGameEngine::olc_SubmitFrame()
+	{
+		olc::ProfileZone zone("Submit Frame");
 
 		// Layer 0 must always exist
 		vLayers[0].bUpdate = true;
 		vLayers[0].bShow = true;
 		SetDecalMode(DecalMode::NORMAL);
-		renderer->PrepareDrawing();
 
-		for (auto layer = vLayers.rbegin(); layer != vLayers.rend(); ++layer)
-		{
-			if (layer->bShow)
+		// The packet is only refilled once the render thread has finished with it
+		std::unique_lock<std::mutex> lock;
+		if (pPipeline)
+		{
+			lock = std::unique_lock<std::mutex>(pPipeline->mux);
+			pPipeline->cvUpdate.wait(lock, [this]() { return !pPipeline->bFramePending; });
+		}
+
+		FramePacket& packet = framePacket;
+		packet.vViewPos = vViewPos;
+		packet.vViewSize = vViewSize;
+		packet.vLayers.resize(vLayers.size());
+
+		statsFrame.nDecalInstances = 0;
+		statsFrame.nDrawCalls = 0;
+		statsFrame.vLayerDecalInstances.assign(vLayers.size(), 0);
+		statsFrame.vLayerDrawCalls.assign(vLayers.size(), 0);
+		size_t nQueueBytes = 0;
+		for (size_t i = 0; i < vLayers.size(); i++)
+		{
+			LayerDesc& layer = vLayers[i];
+			FramePacket::Layer& out = packet.vLayers[i];
+			out.bShow = layer.bShow;
+			out.vOffset = layer.vOffset;
+			out.vScale = layer.vScale;
+			out.tint = layer.tint;
+			out.funcHook = layer.funcHook;
+			out.pDecal = layer.pDrawTarget.Decal();
+			out.pUpload = nullptr;
+			out.vecDecalInstance.clear();
+
+			// Counted as the previous frame was rendered, which is over by now
+			statsFrame.vLayerDrawCalls[i] = out.nDrawCalls;
+			statsFrame.nDrawCalls += out.nDrawCalls;
+			out.nDrawCalls = 0;
+
+			// Hidden and hooked layers keep their decals, as they always have
+			if (layer.bShow && layer.funcHook == nullptr)
 			{
-				if (layer->funcHook == nullptr)
+				// Swapped rather than copied, both queues keep their capacity
+				std::swap(out.vecDecalInstance, layer.vecDecalInstance);
+
+				statsFrame.vLayerDecalInstances[i] = uint32_t(out.vecDecalInstance.size());
+				statsFrame.nDecalInstances += statsFrame.vLayerDecalInstances[i];
+
+				if (!bSuspendTextureTransfer && layer.bUpdate)
 				{
-					renderer->ApplyTexture(layer->pDrawTarget.Decal()->id);
-					if (!bSuspendTextureTransfer && layer->bUpdate)
+					olc::Sprite* pSprite = layer.pDrawTarget.Sprite();
+					out.pUpload = pSprite;
+					if (pPipeline)
 					{
-						layer->pDrawTarget.Decal()->Update();
-						layer->bUpdate = false;
+						// This thread starts drawing the next frame into the layer straight away
+						if (!out.pStaging || out.pStaging->width != pSprite->width || out.pStaging->height != pSprite->height)
+							out.pStaging = std::make_unique<olc::Sprite>(pSprite->width, pSprite->height);
+						std::memcpy(out.pStaging->GetData(), pSprite->pColData.data(), pSprite->pColData.size() * sizeof(olc::Pixel));
+						out.pUpload = out.pStaging.get();
 					}
+					nTextureUploadBytes.fetch_add(pSprite->pColData.size() * sizeof(olc::Pixel), std::memory_order_relaxed);
+					layer.bUpdate = false;
+				}
+			}
+			nQueueBytes += (out.vecDecalInstance.capacity() + layer.vecDecalInstance.capacity()) * sizeof(DecalInstance);
+		}
+		MemoryTracker::Set(MemoryTracker::DECAL_QUEUES, nQueueBytes);
 
-					renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
+		// Responses marked this update are measured when this packet is displayed
+		{
+			LatencyTrackerState& lat = GetLatencyTracker();
+			std::unique_lock<std::mutex> lockLatency(lat.mux);
+			packet.vLatencyMarks.swap(lat.vPending);
+		}
 
-					// Display Decals in order for this layer
-					for (auto& decal : layer->vecDecalInstance)
-						renderer->DrawDecal(decal);
-					layer->vecDecalInstance.clear();
-				}
-				else
+		if (pPipeline)
+		{
+			packet.vCommands.swap(pPipeline->vRecorded);
+			pPipeline->bFramePending = true;
+			pPipeline->bFrameReady = true;
+			lock.unlock();
+			pPipeline->cvRender.notify_one();
+		}
+		else
+			olc_RenderFrame(packet);
+	}
+
+	void PixelGameEngine::olc_RenderFrame(olc::FramePacket& packet)
+	{
+		for (auto& command : packet.vCommands) command();
+		packet.vCommands.clear();
+
+		{
+			olc::ProfileZone zone("Render Layers");
+			renderer->UpdateViewport(packet.vViewPos, packet.vViewSize);
+			renderer->ClearBuffer(olc::BLACK, true);
+			renderer->PrepareDrawing();
+
+			for (auto layer = packet.vLayers.rbegin(); layer != packet.vLayers.rend(); ++layer)
+			{
+				const uint32_t nDrawsBefore = renderer->GetDrawCalls();
+				if (layer->bShow)
 				{
-					// Mwa ha ha.... Have Fun!!!
-					layer->funcHook();
+					if (layer->funcHook == nullptr)
+					{
+						renderer->ApplyTexture(layer->pDecal->id);
+						if (layer->pUpload != nullptr)
+						{
+							olc::ProfileZone zoneUpload("Layer Upload");
+							renderer->UpdateTexture(layer->pDecal->id, layer->pUpload);
+						}
+
+						renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
+
+						// Display Decals in order for this layer
+						olc::ProfileZone zoneDecals("Decals");
+						for (auto& decal : layer->vecDecalInstance)
+							renderer->DrawDecal(decal);
+					}
+					else
+					{
+						// Mwa ha ha.... Have Fun!!!
+						layer->funcHook();
+					}
 				}
+				layer->nDrawCalls = renderer->GetDrawCalls() - nDrawsBefore;
 			}
 		}
 
-		
-
 		// Present Graphics to screen
-		renderer->DisplayFrame();
-
-		// Update Title Bar
-		fFrameTimer += fElapsedTime;
-		nFrameCount++;
-		if (fFrameTimer >= 1.0f)
 		{
-			nLastFPS = nFrameCount;
-			fFrameTimer -= 1.0f;
-			std::string sTitle = "OneLoneCoder.com - Pixel Game Engine - " + sAppName + " - FPS: " + std::to_string(nFrameCount);
-			platform->SetWindowTitle(sTitle);
-			nFrameCount = 0;
+			olc::ProfileZone zone("DisplayFrame");
+			renderer->DisplayFrame();
 		}
+		RecordLatencies(packet.vLatencyMarks);
 	}
 
-	void PixelGameEngine::olc_ConstructFontSheet()
+	void PixelGameEngine::olc_PipelinedLoop()
 	{
-		std::string data;
-		data += "?Q`0001oOch0o01o@F40o0<AGD4090LAGD<090@A7ch0?00O7Q`0600>00000000";
-		data += "O000000nOT0063Qo4d8>?7a14Gno94AA4gno94AaOT0>o3`oO400o7QN00000400";
-		data += "Of80001oOg<7O7moBGT7O7lABET024@aBEd714AiOdl717a_=TH013Q>00000000";
-		data += "720D000V?V5oB3Q_HdUoE7a9@DdDE4A9@DmoE4A;Hg]oM4Aj8S4D84@`00000000";
-		data += "OaPT1000Oa`^13P1@AI[?g`1@A=[OdAoHgljA4Ao?WlBA7l1710007l100000000";
-		data += "ObM6000oOfMV?3QoBDD`O7a0BDDH@5A0BDD<@5A0BGeVO5ao@CQR?5Po00000000";
-		data += "Oc``000?Ogij70PO2D]??0Ph2DUM@7i`2DTg@7lh2GUj?0TO0C1870T?00000000";
-		data += "70<4001o?P<7?1QoHg43O;`h@GT0@:@LB@d0>:@hN@L0@?aoN@<0O7ao0000?000";
-		data += "OcH0001SOglLA7mg24TnK7ln24US>0PL24U140PnOgl0>7QgOcH0K71S0000A000";
-		data += "00H00000@Dm1S007@DUSg00?OdTnH7YhOfTL<7Yh@Cl0700?@Ah0300700000000";
-		data += "<008001QL00ZA41a@6HnI<1i@FHLM81M@@0LG81?O`0nC?Y7?`0ZA7Y300080000";
-		data += "O`082000Oh0827mo6>Hn?Wmo?6HnMb11MP08@C11H`08@FP0@@0004@000000000";
-		data += "00P00001Oab00003OcKP0006@6=PMgl<@440MglH@000000`@000001P00000000";
-		data += "Ob@8@@00Ob@8@Ga13R@8Mga172@8?PAo3R@827QoOb@820@0O`0007`0000007P0";
-		data += "O`000P08Od400g`<3V=P0G`673IP0`@3>1`00P@6O`P00g`<O`000GP800000000";
-		data += "?P9PL020O`<`N3R0@E4HC7b0@ET<ATB0@@l6C4B0O`H3N7b0?P01L3R000000020";
+		// This thread owns the graphics context, so it stays to render and the update moves
+		pPipeline = std::make_unique<PipelineState>();
+		PipelineState& pipe = *pPipeline;
+		pipe.idRender = std::this_thread::get_id();
+		pipe.pDevice = std::move(renderer);
+		renderer = std::make_unique<Renderer_Pipelined>(pipe);
 
-		fontRenderable.Create(128, 48);
+		std::thread update([this, &pipe]()
+		{
+			idUpdateThread = std::this_thread::get_id();
+			while (bAtomActive) { olc_CoreUpdate(); }
+			{
+				std::unique_lock<std::mutex> lock(pipe.mux);
+				pipe.bQuit = true;
+			}
+			pipe.cvRender.notify_one();
+		});
 
-		int px = 0, py = 0;
-		for (size_t b = 0; b < 1024; b += 4)
+		while (true)
 		{
-			uint32_t sym1 = (uint32_t)data[b + 0] - 48;
-			uint32_t sym2 = (uint32_t)data[b + 1] - 48;
-			uint32_t sym3 = (uint32_t)data[b + 2] - 48;
-			uint32_t sym4 = (uint32_t)data[b + 3] - 48;
-			uint32_t r = sym1 << 18 | sym2 << 12 | sym3 << 6 | sym4;
+			std::function<void()> call;
+			{
+				std::unique_lock<std::mutex> lock(pipe.mux);
+				pipe.cvRender.wait(lock, [&pipe]() { return pipe.bQuit || pipe.bFrameReady || !pipe.qCalls.empty(); });
+				if (!pipe.qCalls.empty())
+				{
+					call = std::move(pipe.qCalls.front());
+					pipe.qCalls.pop_front();
+				}
+				else if (pipe.bFrameReady)
+					pipe.bFrameReady = false;
+				else
+					break;
+			}
 
-			for (int i = 0; i < 24; i++)
+			if (call)
 			{
-				int k = r & (1 << i) ? 255 : 0;
-				fontRenderable.Sprite()->SetPixel(px, py, olc::Pixel(k, k, k, k));
-				if (++py == 48) { px++; py = 0; }
+				// The caller is waiting on its result
+				call();
+				continue;
 			}
+
+			olc_RenderFrame(framePacket);
+			{
+				std::unique_lock<std::mutex> lock(pipe.mux);
+				pipe.bFramePending = false;
+			}
+			pipe.cvUpdate.notify_all();
 		}
+		update.join();
+		idUpdateThread = std::this_thread::get_id();
+
+		// Textures released after the last frame was handed over
+		for (auto& command : pipe.vRecorded) command();
+		renderer = std::move(pipe.pDevice);
+		pPipeline.reset();
+	}
 
+	void PixelGameEngine::olc_ConstructFontSheet()
+	{
+		// The sheet is decoded by the compiler, so only needs copying into place
+		fontRenderable.Create(FontSheet::nWidth, FontSheet::nHeight);
+		std::memcpy((void*)fontRenderable.Sprite()->GetData(), fontSheet.pixels.data(), sizeof(fontSheet.pixels));
 		fontRenderable.Decal()->Update();
 
-		constexpr std::array<uint8_t, 96> vSpacing = { {
-			0x03,0x25,0x16,0x08,0x07,0x08,0x08,0x04,0x15,0x15,0x08,0x07,0x15,0x07,0x24,0x08,
-			0x08,0x17,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x24,0x15,0x06,0x07,0x16,0x17,
-			0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x17,0x08,0x08,0x08,
-			0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x08,0x08,0x17,0x08,0x15,0x08,0x15,0x08,0x08,
-			0x24,0x18,0x17,0x17,0x17,0x17,0x17,0x17,0x17,0x33,0x17,0x17,0x33,0x18,0x17,0x17,
-			0x17,0x17,0x17,0x17,0x07,0x17,0x17,0x18,0x18,0x17,0x17,0x07,0x33,0x07,0x08,0x00, } };
-
-		for (auto c : vSpacing) vFontSpacing.push_back({ c >> 4, c & 15 });
+		vFontSpacing.clear();
+		for (auto c : FontSheet::vSpacing) vFontSpacing.push_back({ c >> 4, c & 15 });
 
 		// UK Standard Layout
 #ifdef OLC_KEYBOARD_UK
@@ -4162,6 +7032,216 @@ namespace olc
 #pragma endregion
 
 
+#pragma region image_qoi
+// O------------------------------------------------------------------------------O
+// | START IMAGE LOADER: QOI, "Quite OK Image" format, chosen by file extension   |
+// O------------------------------------------------------------------------------O
+namespace olc
+{
+	class ImageLoader_QOI : public olc::ImageLoader
+	{
+	public:
+		ImageLoader_QOI(std::unique_ptr<olc::ImageLoader> fallback) : ImageLoader(), pFallback(std::move(fallback))
+		{}
+
+		static bool IsQOI(const std::string& sImageFile)
+		{
+			if (sImageFile.size() < 4) return false;
+			std::string ext = sImageFile.substr(sImageFile.size() - 4);
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+			return ext == ".qoi";
+		}
+
+		olc::rcode LoadImageResource(olc::Sprite* spr, const std::string& sImageFile, olc::ResourcePack* pack) override
+		{
+			if (!IsQOI(sImageFile))
+				return pFallback ? pFallback->LoadImageResource(spr, sImageFile, pack) : olc::rcode::FAIL;
+
+			std::vector<char> vFile;
+			if (pack != nullptr)
+			{
+				ResourceBuffer rb = pack->GetFileBuffer(sImageFile);
+				vFile = std::move(rb.vMemory);
+			}
+			else
+			{
+				std::ifstream ifs(sImageFile, std::ifstream::binary);
+				if (!ifs.is_open()) return olc::rcode::NO_FILE;
+				ifs.seekg(0, std::ios::end);
+				vFile.resize(size_t(ifs.tellg()));
+				ifs.seekg(0, std::ios::beg);
+				ifs.read(vFile.data(), vFile.size());
+			}
+
+			spr->pColData.clear();
+			return Decode(spr, (const uint8_t*)vFile.data(), vFile.size());
+		}
+
+		olc::rcode SaveImageResource(olc::Sprite* spr, const std::string& sImageFile) override
+		{
+			if (!IsQOI(sImageFile))
+				return pFallback ? pFallback->SaveImageResource(spr, sImageFile) : olc::rcode::FAIL;
+
+			std::vector<uint8_t> vFile = Encode(spr);
+			std::ofstream ofs(sImageFile, std::ofstream::binary);
+			if (!ofs.is_open()) return olc::rcode::FAIL;
+			ofs.write((const char*)vFile.data(), vFile.size());
+			return ofs.good() ? olc::rcode::OK : olc::rcode::FAIL;
+		}
+
+	private:
+		enum : uint8_t
+		{
+			OP_INDEX = 0x00, OP_DIFF = 0x40, OP_LUMA = 0x80, OP_RUN = 0xC0,
+			OP_RGB = 0xFE, OP_RGBA = 0xFF, OP_MASK = 0xC0
+		};
+
+		static constexpr size_t nHeaderSize = 14;
+		static constexpr size_t nPaddingSize = 8;
+
+		static inline uint8_t Hash(const olc::Pixel& p)
+		{ return uint8_t((p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) & 63); }
+
+		static olc::rcode Decode(olc::Sprite* spr, const uint8_t* pData, size_t nSize)
+		{
+			if (nSize < nHeaderSize + nPaddingSize || std::memcmp(pData, "qoif", 4) != 0) return olc::rcode::FAIL;
+			auto read32 = [](const uint8_t* p) { return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]); };
+			const uint32_t w = read32(pData + 4), h = read32(pData + 8);
+			if (w == 0 || h == 0 || uint64_t(w) * h > (uint64_t(1) << 28)) return olc::rcode::FAIL;
+
+			spr->width = int32_t(w); spr->height = int32_t(h);
+			spr->pColData.resize(size_t(w) * h);
+
+			olc::Pixel index[64];
+			std::fill_n(index, 64, olc::Pixel(0, 0, 0, 0));
+			olc::Pixel px(0, 0, 0, 255);
+
+			const uint8_t* p = pData + nHeaderSize;
+			const uint8_t* pEnd = pData + nSize - nPaddingSize;
+			olc::Pixel* pOut = spr->pColData.data();
+			olc::Pixel* pOutEnd = pOut + spr->pColData.size();
+
+			while (pOut < pOutEnd && p < pEnd)
+			{
+				const uint8_t b1 = *p++;
+				if (b1 == OP_RGB)
+				{
+					px.r = p[0]; px.g = p[1]; px.b = p[2]; p += 3;
+				}
+				else if (b1 == OP_RGBA)
+				{
+					px.r = p[0]; px.g = p[1]; px.b = p[2]; px.a = p[3]; p += 4;
+				}
+				else switch (b1 & OP_MASK)
+				{
+				case OP_INDEX:
+					px = index[b1];
+					break;
+				case OP_DIFF:
+					px.r += ((b1 >> 4) & 0x03) - 2;
+					px.g += ((b1 >> 2) & 0x03) - 2;
+					px.b += (b1 & 0x03) - 2;
+					break;
+				case OP_LUMA:
+				{
+					const uint8_t b2 = *p++;
+					const int dg = (b1 & 0x3F) - 32;
+					px.r += dg - 8 + ((b2 >> 4) & 0x0F);
+					px.g += dg;
+					px.b += dg - 8 + (b2 & 0x0F);
+					break;
+				}
+				case OP_RUN:
+				{
+					// Runs are the common case for flat art, fill them in one go
+					const size_t nRun = std::min(size_t(b1 & 0x3F) + 1, size_t(pOutEnd - pOut));
+					std::fill_n(pOut, nRun, px);
+					pOut += nRun;
+					continue;
+				}
+				}
+				index[Hash(px)] = px;
+				*pOut++ = px;
+			}
+
+			// Truncated stream, leave the remainder transparent rather than fail
+			std::fill(pOut, pOutEnd, olc::Pixel(0, 0, 0, 0));
+			return olc::rcode::OK;
+		}
+
+		static std::vector<uint8_t> Encode(const olc::Sprite* spr)
+		{
+			const size_t nPixels = spr->pColData.size();
+			std::vector<uint8_t> vOut;
+			vOut.reserve(nHeaderSize + nPixels * 5 + nPaddingSize);
+
+			auto write32 = [&vOut](uint32_t v) { for (int s = 24; s >= 0; s -= 8) vOut.push_back(uint8_t(v >> s)); };
+			vOut.insert(vOut.end(), { 'q', 'o', 'i', 'f' });
+			write32(uint32_t(spr->width)); write32(uint32_t(spr->height));
+			vOut.push_back(4); // RGBA
+			vOut.push_back(0); // sRGB with linear alpha
+
+			olc::Pixel index[64];
+			std::fill_n(index, 64, olc::Pixel(0, 0, 0, 0));
+			olc::Pixel prev(0, 0, 0, 255);
+			int nRun = 0;
+
+			for (size_t i = 0; i < nPixels; i++)
+			{
+				const olc::Pixel px = spr->pColData[i];
+				if (px == prev)
+				{
+					nRun++;
+					if (nRun == 62 || i == nPixels - 1) { vOut.push_back(uint8_t(OP_RUN | (nRun - 1))); nRun = 0; }
+					continue;
+				}
+
+				if (nRun > 0) { vOut.push_back(uint8_t(OP_RUN | (nRun - 1))); nRun = 0; }
+
+				const uint8_t h = Hash(px);
+				if (index[h] == px)
+				{
+					vOut.push_back(uint8_t(OP_INDEX | h));
+				}
+				else
+				{
+					index[h] = px;
+					if (px.a == prev.a)
+					{
+						const int8_t dr = int8_t(px.r - prev.r), dg = int8_t(px.g - prev.g), db = int8_t(px.b - prev.b);
+						const int8_t dr_dg = int8_t(dr - dg), db_dg = int8_t(db - dg);
+
+						if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+							vOut.push_back(uint8_t(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+						else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8)
+						{
+							vOut.push_back(uint8_t(OP_LUMA | (dg + 32)));
+							vOut.push_back(uint8_t((dr_dg + 8) << 4 | (db_dg + 8)));
+						}
+						else
+							vOut.insert(vOut.end(), { OP_RGB, px.r, px.g, px.b });
+					}
+					else
+						vOut.insert(vOut.end(), { OP_RGBA, px.r, px.g, px.b, px.a });
+				}
+				prev = px;
+			}
+
+			vOut.insert(vOut.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+			return vOut;
+		}
+
+	private:
+		std::unique_ptr<olc::ImageLoader> pFallback;
+	};
+}
+// O------------------------------------------------------------------------------O
+// | END IMAGE LOADER: QOI                                                        |
+// O------------------------------------------------------------------------------O
+#pragma endregion
+
+
+
 
 #if !defined(OLC_PGE_HEADLESS)
 
@@ -4205,6 +7285,11 @@ namespace olc
 	#include <OpenGL/glu.h>
 #endif
 
+// Windows headers stop at OpenGL 1.1, mip level limits arrived in 1.2
+#if !defined(GL_TEXTURE_MAX_LEVEL)
+	#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
 namespace olc
 {
 	class Renderer_OGL10 : public olc::Renderer
@@ -4403,6 +7488,7 @@ namespace olc
 			glTexCoord2f(1.0f * scale.x + offset.x, 1.0f * scale.y + offset.y);
 			glVertex3f(1.0f /*+ vSubPixelOffset.x*/, -1.0f /*+ vSubPixelOffset.y*/, 0.0f);
 			glEnd();
+			nDrawCalls++;
 		}
 
 		void DrawDecal(const olc::DecalInstance& decal) override
@@ -4447,6 +7533,7 @@ namespace olc
 				}
 
 				glEnd();
+				nDrawCalls++;
 
 				glMatrixMode(GL_PROJECTION); glPopMatrix();
 				glMatrixMode(GL_MODELVIEW);  glPopMatrix();
@@ -4476,6 +7563,7 @@ namespace olc
 				}
 
 				glEnd();
+				nDrawCalls++;
 			}
 			
 
@@ -4524,12 +7612,30 @@ namespace olc
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			UNUSED(id);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->pColData.data());
+		}
+
+		void UpdateTextureMips(uint32_t id, olc::Sprite* spr) override
+		{
+			UNUSED(id);
+			// Texture must already be bound, see ApplyTexture()
+			for (size_t i = 0; i < spr->GetMipCount(); i++)
+			{
+				const olc::Sprite* mip = spr->GetMip(i);
+				glTexImage2D(GL_TEXTURE_2D, GLint(i), GL_RGBA, mip->width, mip->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, mip->pColData.data());
+			}
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(spr->GetMipCount() - 1));
+
+			// Keep the filtering chosen at creation, but blend between levels to match it
+			GLint nMagFilter = GL_NEAREST;
+			glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &nMagFilter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, nMagFilter == GL_LINEAR ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST);
 		}
 
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
-			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			// Texture must already be bound, see ApplyTexture()
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
 		void ApplyTexture(uint32_t id) override
@@ -4990,6 +8096,7 @@ namespace olc
 
 			locBufferData(0x8892, sizeof(locVertex) * 4, verts, 0x88E0);
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			nDrawCalls++;
 		}
 
 		void DrawDecal(const olc::DecalInstance& decal) override
@@ -5018,6 +8125,7 @@ namespace olc
 				else if (decal.structure == olc::DecalStructure::LIST)
 					glDrawArrays(GL_TRIANGLES, 0, decal.points);
 			}
+			nDrawCalls++;
 		}
 
 		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered, const bool clamp) override
@@ -5064,12 +8172,38 @@ namespace olc
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			UNUSED(id);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->pColData.data());
+		}
+
+		// GLES2 cannot mip textures that are not a power of two in size, so Emscripten keeps the default
+#if !defined(OLC_PLATFORM_EMSCRIPTEN)
+		void UpdateTextureMips(uint32_t id, olc::Sprite* spr) override
+		{
+			UNUSED(id);
+			// Texture must already be bound, see ApplyTexture()
+			for (size_t i = 0; i < spr->GetMipCount(); i++)
+			{
+				const olc::Sprite* mip = spr->GetMip(i);
+				glTexImage2D(GL_TEXTURE_2D, GLint(i), GL_RGBA, mip->width, mip->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, mip->pColData.data());
+			}
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(spr->GetMipCount() - 1));
+
+			// Keep the filtering chosen at creation, but blend between levels to match it
+			GLint nMagFilter = GL_NEAREST;
+			glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &nMagFilter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, nMagFilter == GL_LINEAR ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST);
 		}
+#endif
 
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
+#if defined(OLC_PLATFORM_EMSCRIPTEN)
+			// GLES cannot read textures back directly
 			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+#else
+			// Texture must already be bound, see ApplyTexture()
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+#endif
 		}
 
 		void ApplyTexture(uint32_t id) override
@@ -5621,6 +8755,18 @@ namespace olc
 		X11::Colormap                olc_ColourMap;
 		X11::XSetWindowAttributes    olc_SetWindowAttribs;
 
+		// Every keysym the engine maps is either Latin-1 (0x00xx) or from the
+		// function key page (0xFFxx), so one flat table covers both pages and
+		// looking a key up is a single index rather than a map search
+		std::array<uint8_t, 512> vKeyTable{};
+
+		uint8_t MapKeySym(X11::KeySym sym) const
+		{
+			if (sym < 0x100) return vKeyTable[sym];
+			if ((sym & ~X11::KeySym(0xFF)) == 0xFF00) return vKeyTable[0x100 | (sym & 0xFF)];
+			return Key::NONE;
+		}
+
 	public:
 		virtual olc::rcode ApplicationStartUp() override
 		{
@@ -5683,6 +8829,9 @@ namespace olc
 			Atom wmDelete = XInternAtom(olc_Display, "WM_DELETE_WINDOW", true);
 			XSetWMProtocols(olc_Display, olc_Window, &wmDelete, 1);
 
+			// Held keys repeat as presses alone, not as release and press pairs
+			XkbSetDetectableAutoRepeat(olc_Display, True, nullptr);
+
 			XMapWindow(olc_Display, olc_Window);
 			XStoreName(olc_Display, olc_Window, "OneLoneCoder.com - Pixel Game Engine");
 
@@ -5755,6 +8904,14 @@ namespace olc
 
 			mapKeys[XK_Caps_Lock] = Key::CAPS_LOCK;
 
+			// mapKeys is kept for GetKeyMap(), events are translated with the table
+			vKeyTable.fill(Key::NONE);
+			for (const auto& k : mapKeys)
+			{
+				if (k.first < 0x100) vKeyTable[k.first] = k.second;
+				else if ((k.first & ~size_t(0xFF)) == 0xFF00) vKeyTable[0x100 | (k.first & 0xFF)] = k.second;
+			}
+
 			return olc::OK;
 		}
 
@@ -5772,79 +8929,106 @@ namespace olc
 		virtual olc::rcode HandleSystemEvent() override
 		{
 			using namespace X11;
-			// Handle Xlib Message Loop - we do this in the
-			// same thread that OpenGL was created so we dont
-			// need to worry too much about multithreading with X11
+			// Handle Xlib Message Loop - this runs on the update thread, from the
+			// engine loop and from the frame pacer while it idles. With pipelined
+			// rendering the render thread owns the GLX context and swaps buffers on
+			// the same display connection at the same time, which is only safe
+			// because CreateWindowPane() calls XInitThreads() before anything else
+			//
+			// The connection is flushed once per frame, then everything already
+			// queued is drained, reading more from the socket only when the queue
+			// runs dry. A run of MotionNotify events is collapsed into its last
+			// position, which is sent before the next event of any other kind so
+			// button presses still see the cursor where they happened.
 			XEvent xev;
-			while (XPending(olc_Display))
+			bool bMotion = false;
+			int nMotionX = 0, nMotionY = 0;
+			auto FlushMotion = [&]()
 			{
-				XNextEvent(olc_Display, &xev);
-				if (xev.type == Expose)
-				{
-					XWindowAttributes gwa;
-					XGetWindowAttributes(olc_Display, olc_Window, &gwa);
-					ptrPGE->olc_UpdateWindowSize(gwa.width, gwa.height);
-				}
-				else if (xev.type == ConfigureNotify)
-				{
-					XConfigureEvent xce = xev.xconfigure;
-					ptrPGE->olc_UpdateWindowSize(xce.width, xce.height);
-				}
-				else if (xev.type == KeyPress)
-				{
-					KeySym sym = XLookupKeysym(&xev.xkey, 0);
-					ptrPGE->olc_UpdateKeyState(mapKeys[sym], true);
-					XKeyEvent* e = (XKeyEvent*)&xev; // Because DragonEye loves numpads
-					XLookupString(e, NULL, 0, &sym, NULL);
-					ptrPGE->olc_UpdateKeyState(mapKeys[sym], true);
-				}
-				else if (xev.type == KeyRelease)
-				{
-					KeySym sym = XLookupKeysym(&xev.xkey, 0);
-					ptrPGE->olc_UpdateKeyState(mapKeys[sym], false);
-					XKeyEvent* e = (XKeyEvent*)&xev;
-					XLookupString(e, NULL, 0, &sym, NULL);
-					ptrPGE->olc_UpdateKeyState(mapKeys[sym], false);
-				}
-				else if (xev.type == ButtonPress)
+				if (!bMotion) return;
+				ptrPGE->olc_UpdateMouse(nMotionX, nMotionY);
+				bMotion = false;
+			};
+
+			for (int nPending = XPending(olc_Display); nPending > 0; nPending = XEventsQueued(olc_Display, QueuedAfterReading))
+			{
+				while (nPending-- > 0)
 				{
-					switch (xev.xbutton.button)
+					XNextEvent(olc_Display, &xev);
+					if (xev.type == MotionNotify)
 					{
-					case 1:	ptrPGE->olc_UpdateMouseState(0, true); break;
-					case 2:	ptrPGE->olc_UpdateMouseState(2, true); break;
-					case 3:	ptrPGE->olc_UpdateMouseState(1, true); break;
-					case 4:	ptrPGE->olc_UpdateMouseWheel(120); break;
-					case 5:	ptrPGE->olc_UpdateMouseWheel(-120); break;
-					default: break;
+						bMotion = true;
+						nMotionX = xev.xmotion.x;
+						nMotionY = xev.xmotion.y;
+						continue;
 					}
-				}
-				else if (xev.type == ButtonRelease)
-				{
-					switch (xev.xbutton.button)
+
+					FlushMotion();
+					if (xev.type == Expose)
 					{
-					case 1:	ptrPGE->olc_UpdateMouseState(0, false); break;
-					case 2:	ptrPGE->olc_UpdateMouseState(2, false); break;
-					case 3:	ptrPGE->olc_UpdateMouseState(1, false); break;
-					default: break;
+						// Only the last of a batch of exposures needs the round trip
+						if (xev.xexpose.count > 0) continue;
+						XWindowAttributes gwa;
+						XGetWindowAttributes(olc_Display, olc_Window, &gwa);
+						ptrPGE->olc_UpdateWindowSize(gwa.width, gwa.height);
+					}
+					else if (xev.type == ConfigureNotify)
+					{
+						XConfigureEvent xce = xev.xconfigure;
+						ptrPGE->olc_UpdateWindowSize(xce.width, xce.height);
+					}
+					else if (xev.type == KeyPress || xev.type == KeyRelease)
+					{
+						// The unshifted keysym covers nearly every key. Only when that has no
+						// mapping is the event translated with modifiers applied, which is what
+						// turns keypad navigation keys into digits when NumLock is on
+						// (because DragonEye loves numpads)
+						uint8_t key = MapKeySym(XLookupKeysym(&xev.xkey, 0));
+						if (key == Key::NONE)
+						{
+							KeySym sym = 0;
+							XLookupString(&xev.xkey, NULL, 0, &sym, NULL);
+							key = MapKeySym(sym);
+						}
+						ptrPGE->olc_UpdateKeyState(key, xev.type == KeyPress);
+					}
+					else if (xev.type == ButtonPress)
+					{
+						switch (xev.xbutton.button)
+						{
+						case 1:	ptrPGE->olc_UpdateMouseState(0, true); break;
+						case 2:	ptrPGE->olc_UpdateMouseState(2, true); break;
+						case 3:	ptrPGE->olc_UpdateMouseState(1, true); break;
+						case 4:	ptrPGE->olc_UpdateMouseWheel(120); break;
+						case 5:	ptrPGE->olc_UpdateMouseWheel(-120); break;
+						default: break;
+						}
+					}
+					else if (xev.type == ButtonRelease)
+					{
+						switch (xev.xbutton.button)
+						{
+						case 1:	ptrPGE->olc_UpdateMouseState(0, false); break;
+						case 2:	ptrPGE->olc_UpdateMouseState(2, false); break;
+						case 3:	ptrPGE->olc_UpdateMouseState(1, false); break;
+						default: break;
+						}
+					}
+					else if (xev.type == FocusIn)
+					{
+						ptrPGE->olc_UpdateKeyFocus(true);
+					}
+					else if (xev.type == FocusOut)
+					{
+						ptrPGE->olc_UpdateKeyFocus(false);
+					}
+					else if (xev.type == ClientMessage)
+					{
+						ptrPGE->olc_Terminate();
 					}
-				}
-				else if (xev.type == MotionNotify)
-				{
-					ptrPGE->olc_UpdateMouse(xev.xmotion.x, xev.xmotion.y);
-				}
-				else if (xev.type == FocusIn)
-				{
-					ptrPGE->olc_UpdateKeyFocus(true);
-				}
-				else if (xev.type == FocusOut)
-				{
-					ptrPGE->olc_UpdateKeyFocus(false);
-				}
-				else if (xev.type == ClientMessage)
-				{
-					ptrPGE->olc_Terminate();
 				}
 			}
+			FlushMotion();
 			return olc::OK;
 		}
 	};
@@ -5910,6 +9094,7 @@ namespace olc {
 				*bActiveRef = true;
 				return;
 			}
+			ptrPGE->GetJobSystem().Stop();
 			platform->ThreadCleanUp();
 			platform->ApplicationCleanUp();
 			exit(0);
@@ -6593,6 +9778,221 @@ extern "C"
 
 #endif // Headless
 
+#pragma region image_cache
+// O------------------------------------------------------------------------------O
+// | START IMAGE LOADER: Decoded RGBA cache, wraps whichever loader is in use     |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_IMAGE_CACHE)
+#if !defined(OLC_IMAGE_CACHE_DIR)
+	#define OLC_IMAGE_CACHE_DIR ".pgecache"
+#endif
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace olc
+{
+	class ImageLoader_Cache : public olc::ImageLoader
+	{
+	public:
+		ImageLoader_Cache(std::unique_ptr<olc::ImageLoader> source) : ImageLoader(), pSource(std::move(source))
+		{}
+
+		olc::rcode LoadImageResource(olc::Sprite* spr, const std::string& sImageFile, olc::ResourcePack* pack) override
+		{
+			// Pack entries have no meaningful timestamp, so always decode them
+			if (pack != nullptr || !pSource) return pSource ? pSource->LoadImageResource(spr, sImageFile, pack) : olc::rcode::FAIL;
+
+			std::error_code ec;
+			if (!_gfs::exists(sImageFile, ec)) return olc::rcode::NO_FILE;
+
+			sHeader key;
+			key.nSourceSize = uint64_t(_gfs::file_size(sImageFile, ec));
+			key.nSourceTime = int64_t(_gfs::last_write_time(sImageFile, ec).time_since_epoch().count());
+			key.nPathSize = uint32_t(sImageFile.size());
+			const std::string sCacheFile = CacheFileName(sImageFile);
+
+			if (ReadCache(spr, sCacheFile, sImageFile, key)) return olc::rcode::OK;
+
+			// Miss - decode as normal, then store result for next time
+			olc::rcode r = pSource->LoadImageResource(spr, sImageFile, pack);
+			if (r == olc::rcode::OK) WriteCache(spr, sCacheFile, sImageFile, key);
+			return r;
+		}
+
+		olc::rcode SaveImageResource(olc::Sprite* spr, const std::string& sImageFile) override
+		{
+			return pSource ? pSource->SaveImageResource(spr, sImageFile) : olc::rcode::FAIL;
+		}
+
+	private:
+		struct sHeader
+		{
+			char     sMagic[4] = { 'O', 'L', 'C', 'R' };
+			uint32_t nVersion = 1;
+			int32_t  nWidth = 0;
+			int32_t  nHeight = 0;
+			uint64_t nSourceSize = 0;
+			int64_t  nSourceTime = 0;
+			uint32_t nPathSize = 0;
+			uint32_t nReserved = 0;
+		};
+
+		// Pixel data follows header and path, on a 16 byte boundary
+		static size_t PixelOffset(uint32_t nPathSize)
+		{ return (sizeof(sHeader) + nPathSize + 15) & ~size_t(15); }
+
+		static std::string CacheFileName(const std::string& sImageFile)
+		{
+			uint64_t h = 0xcbf29ce484222325ull; // FNV-1a
+			for (auto c : sImageFile) { h ^= uint8_t(c == '\\' ? '/' : c); h *= 0x100000001b3ull; }
+			std::string sName(16, '0');
+			for (int i = 15; i >= 0; i--, h >>= 4) sName[i] = "0123456789abcdef"[h & 0xF];
+			return std::string(OLC_IMAGE_CACHE_DIR) + "/" + sName + ".rgba";
+		}
+
+		bool ReadCache(olc::Sprite* spr, const std::string& sCacheFile, const std::string& sImageFile, const sHeader& key)
+		{
+			bool bHit = false;
+			size_t nFileSize = 0;
+			const uint8_t* pData = nullptr;
+
+#if defined(_WIN32)
+			HANDLE hFile = CreateFileA(sCacheFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (hFile == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER li; GetFileSizeEx(hFile, &li); nFileSize = size_t(li.QuadPart);
+			HANDLE hMap = nFileSize > 0 ? CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+			if (hMap) pData = (const uint8_t*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+#else
+			int fd = open(sCacheFile.c_str(), O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			if (fstat(fd, &st) == 0) nFileSize = size_t(st.st_size);
+			if (nFileSize > 0)
+			{
+				void* p = mmap(nullptr, nFileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED) pData = (const uint8_t*)p;
+			}
+#endif
+
+			if (pData != nullptr && nFileSize >= sizeof(sHeader))
+			{
+				sHeader h;
+				std::memcpy(&h, pData, sizeof(sHeader));
+				const size_t nOffset = PixelOffset(h.nPathSize);
+				const size_t nPixels = size_t(std::max(h.nWidth, 0)) * size_t(std::max(h.nHeight, 0));
+
+				bHit = std::memcmp(h.sMagic, key.sMagic, 4) == 0 && h.nVersion == key.nVersion
+					&& h.nSourceSize == key.nSourceSize && h.nSourceTime == key.nSourceTime
+					&& h.nPathSize == key.nPathSize && nFileSize >= nOffset + nPixels * sizeof(olc::Pixel)
+					&& std::memcmp(pData + sizeof(sHeader), sImageFile.data(), h.nPathSize) == 0;
+
+				if (bHit)
+				{
+					// One straight copy out of the mapping, the pages are faulted in as it goes
+					spr->width = h.nWidth; spr->height = h.nHeight;
+					const olc::Pixel* pPixels = reinterpret_cast<const olc::Pixel*>(pData + nOffset);
+					spr->pColData.assign(pPixels, pPixels + nPixels);
+				}
+			}
+
+#if defined(_WIN32)
+			if (pData) UnmapViewOfFile(pData);
+			if (hMap) CloseHandle(hMap);
+			CloseHandle(hFile);
+#else
+			if (pData) munmap((void*)pData, nFileSize);
+			close(fd);
+#endif
+			return bHit;
+		}
+
+		void WriteCache(olc::Sprite* spr, const std::string& sCacheFile, const std::string& sImageFile, sHeader h)
+		{
+			std::error_code ec;
+			_gfs::create_directories(OLC_IMAGE_CACHE_DIR, ec);
+
+			h.nWidth = spr->width; h.nHeight = spr->height;
+			const size_t nOffset = PixelOffset(h.nPathSize);
+			std::vector<char> vPad(nOffset - sizeof(sHeader) - h.nPathSize, 0);
+
+			// Write to a temporary, then move into place, so a reader never sees half a file.
+			// Each writer has its own, other processes and threads may be caching the same image
+			static std::atomic<uint32_t> nTempCounter{ 0 };
+#if defined(_WIN32)
+			const unsigned long nProcess = GetCurrentProcessId();
+#else
+			const unsigned long nProcess = (unsigned long)getpid();
+#endif
+			const std::string sTempFile = sCacheFile + "." + std::to_string(nProcess) + "." + std::to_string(nTempCounter++) + ".tmp";
+			{
+				std::ofstream ofs(sTempFile, std::ofstream::binary);
+				if (!ofs.is_open()) return;
+				ofs.write((const char*)&h, sizeof(sHeader));
+				ofs.write(sImageFile.data(), h.nPathSize);
+				ofs.write(vPad.data(), vPad.size());
+				ofs.write((const char*)spr->pColData.data(), spr->pColData.size() * sizeof(olc::Pixel));
+				if (!ofs.good()) { ofs.close(); _gfs::remove(sTempFile, ec); return; }
+			}
+			_gfs::rename(sTempFile, sCacheFile, ec);
+			if (ec) _gfs::remove(sTempFile, ec);
+		}
+
+	private:
+		std::unique_ptr<olc::ImageLoader> pSource;
+	};
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END IMAGE LOADER: Decoded RGBA cache                                         |
+// O------------------------------------------------------------------------------O
+#pragma endregion
+
+#pragma region allocation_tracking
+// O------------------------------------------------------------------------------O
+// | START ALLOCATION TRACKING: Counts heap allocations for FrameStats            |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_TRACK_ALLOCATIONS)
+// The array and nothrow forms are defined in terms of these, so replacing the
+// single object pair catches everything but over-aligned allocations
+void* operator new(std::size_t nBytes)
+{
+	olc::nHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (nBytes == 0) nBytes = 1;
+	while (true)
+	{
+		if (void* p = std::malloc(nBytes)) return p;
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr) throw std::bad_alloc();
+		handler();
+	}
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+// GCC pairs inlined calls to free() with the library operator new, not this one
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
+// O------------------------------------------------------------------------------O
+// | END ALLOCATION TRACKING                                                      |
+// O------------------------------------------------------------------------------O
+#pragma endregion
+
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine Auto-Configuration                                        |
 // O------------------------------------------------------------------------------O
@@ -6622,6 +10022,13 @@ namespace olc
 		olc::Sprite::loader = std::make_unique<OLC_IMAGE_CUSTOM_EX>();
 #endif
 
+		// .qoi files are handled in-tree, anything else goes to the loader above
+		olc::Sprite::loader = std::make_unique<olc::ImageLoader_QOI>(std::move(olc::Sprite::loader));
+
+#if defined(OLC_IMAGE_CACHE)
+		olc::Sprite::loader = std::make_unique<olc::ImageLoader_Cache>(std::move(olc::Sprite::loader));
+#endif
+
 
 #if defined(OLC_PLATFORM_HEADLESS)
 		platform = std::make_unique<olc::Platform_Headless>();
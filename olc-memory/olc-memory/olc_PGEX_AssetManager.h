@@ -0,0 +1,202 @@
+/*
+	olcPGEX_AssetManager.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                     Asset Manager v1.0                      |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	A central registry for olc::Renderables. Ask it for a file, either on disk
+	or inside a resource pack, and it hands back a shared handle. Asking again
+	for the same file returns the same handle without loading it twice.
+
+	Assets stay resident while anyone holds a handle to them. Once the last
+	handle is dropped the asset is kept around in case it is wanted again, but
+	if the textures held by the manager exceed its budget, the least recently
+	used unreferenced assets are released first. Referenced assets are never
+	released, so the budget can be exceeded if everything is in use.
+
+	Loading creates textures, so like olc::Renderable::Load() it must be done
+	on the thread that owns the renderer, e.g. within OnUserCreate/Update.
+
+	Usage
+	~~~~~
+	#define OLC_PGEX_ASSETMANAGER
+	#include "olc_PGEX_AssetManager.h"
+
+	olc::AssetManager assets(32 * 1024 * 1024);
+	std::shared_ptr<olc::Renderable> star = assets.Load("data/decals/StarShape.png");
+	DrawDecal({ 0, 0 }, star->Decal());
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2022 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Revisions:
+	1.00:	Initial Release
+*/
+
+#pragma once
+
+#include "olcPixelGameEngine.h"
+#include <list>
+#include <unordered_map>
+
+namespace olc
+{
+	class AssetManager
+	{
+	public:
+		AssetManager(size_t nBudgetBytes = 64 * 1024 * 1024);
+
+	public:
+		// Returns a shared handle to the asset, loading it if it is not already resident.
+		// Options only apply to the first load, later calls get the existing asset.
+		// Returns nullptr if the file could not be loaded
+		std::shared_ptr<olc::Renderable> Load(const std::string& sFile, olc::ResourcePack* pack = nullptr, bool filter = false, bool clamp = true, bool gpuonly = false, bool mipmap = false);
+		// Sets how many bytes of texture the manager may keep, and evicts down to it
+		void SetBudget(size_t nBudgetBytes);
+		// Releases unreferenced assets, least recently used first, until within budget
+		void Collect();
+		// Releases all unreferenced assets regardless of budget
+		void Purge();
+
+		size_t GetResidentBytes() const;
+		size_t GetResidentCount() const;
+
+	private:
+		struct sEntry
+		{
+			std::shared_ptr<olc::Renderable> pAsset;
+			size_t nBytes = 0;
+			std::list<std::string>::iterator itLRU;
+		};
+
+		void Evict(size_t nTargetBytes);
+
+	private:
+		std::unordered_map<std::string, sEntry> mapAssets;
+		// Most recently used at the front
+		std::list<std::string> listLRU;
+		size_t nBudget = 0;
+		size_t nResident = 0;
+	};
+}
+
+#ifdef OLC_PGEX_ASSETMANAGER
+#undef OLC_PGEX_ASSETMANAGER
+
+namespace olc
+{
+	AssetManager::AssetManager(size_t nBudgetBytes) : nBudget(nBudgetBytes)
+	{
+	}
+
+	std::shared_ptr<olc::Renderable> AssetManager::Load(const std::string& sFile, olc::ResourcePack* pack, bool filter, bool clamp, bool gpuonly, bool mipmap)
+	{
+		// The same path may exist on disk and in any number of packs
+		std::string sKey = sFile;
+		if (pack != nullptr) sKey = std::to_string(reinterpret_cast<uintptr_t>(pack)) + ":" + sFile;
+
+		auto it = mapAssets.find(sKey);
+		if (it != mapAssets.end())
+		{
+			listLRU.splice(listLRU.begin(), listLRU, it->second.itLRU);
+
+			// A previous user did not want the pixels, but this one does
+			olc::Renderable* r = it->second.pAsset.get();
+			if (!gpuonly && r->Sprite()->pColData.empty())
+				r->Decal()->UpdateSprite();
+
+			return it->second.pAsset;
+		}
+
+		auto asset = std::make_shared<olc::Renderable>();
+		if (asset->Load(sFile, pack, filter, clamp, gpuonly, mipmap) != olc::rcode::OK)
+			return nullptr;
+
+		sEntry e;
+		e.pAsset = asset;
+		e.nBytes = size_t(asset->Sprite()->width) * size_t(asset->Sprite()->height) * sizeof(olc::Pixel);
+		// A full mip chain adds a third again
+		if (mipmap) e.nBytes += e.nBytes / 3;
+		listLRU.push_front(sKey);
+		e.itLRU = listLRU.begin();
+		nResident += e.nBytes;
+		mapAssets.emplace(sKey, std::move(e));
+
+		Evict(nBudget);
+		return asset;
+	}
+
+	void AssetManager::SetBudget(size_t nBudgetBytes)
+	{
+		nBudget = nBudgetBytes;
+		Evict(nBudget);
+	}
+
+	void AssetManager::Collect()
+	{
+		Evict(nBudget);
+	}
+
+	void AssetManager::Purge()
+	{
+		Evict(0);
+	}
+
+	size_t AssetManager::GetResidentBytes() const
+	{ return nResident; }
+
+	size_t AssetManager::GetResidentCount() const
+	{ return mapAssets.size(); }
+
+	void AssetManager::Evict(size_t nTargetBytes)
+	{
+		// Walk from least recently used, skipping anything still held elsewhere
+		auto it = listLRU.end();
+		while (nResident > nTargetBytes && it != listLRU.begin())
+		{
+			--it;
+			auto entry = mapAssets.find(*it);
+			if (entry->second.pAsset.use_count() > 1) continue;
+
+			nResident -= entry->second.nBytes;
+			mapAssets.erase(entry);
+			it = listLRU.erase(it);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,271 @@
+/*
+	olcPGEX_PerfOverlay.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                  Performance Overlay v1.0                   |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	A small panel drawn over the top of your application showing how the
+	last couple of seconds of frames went: a frame time graph, the median and
+	99th percentile frame times, decal instances and draw calls per layer,
+	bytes uploaded to textures, and allocations made each frame.
+
+	The panel is drawn into its own sprite, which is only refreshed a few
+	times a second, and shown with a single decal on layer 0. That decal
+	instance and the panel's own uploads are left out of the numbers it shows,
+	the draws are shown as the renderer counted them, the panel's included.
+
+	Heap allocations are only counted if OLC_TRACK_ALLOCATIONS is defined
+	where the engine implementation is compiled, otherwise "-" is shown and
+	only pixel buffer allocations are reported.
+
+	Usage
+	~~~~~
+	#define OLC_PGEX_PERFOVERLAY
+	#include "olc_PGEX_PerfOverlay.h"
+
+	// As a member of your application, toggled with F3 by default
+	olc::PerfOverlay overlay;
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2022 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Revisions:
+	1.00:	Initial Release
+*/
+
+#pragma once
+
+#include "olcPixelGameEngine.h"
+
+namespace olc
+{
+	class PerfOverlay : public olc::PGEX
+	{
+	public:
+		PerfOverlay(olc::Key toggleKey = olc::Key::F3);
+
+	public:
+		void Show(bool bShow);
+		bool IsShown() const;
+		void SetToggleKey(olc::Key key);
+		// Where the panel's top left corner is drawn, in screen pixels. Defaults to the top right
+		void SetPosition(const olc::vf2d& pos);
+		// How often the panel's texture is redrawn, in seconds
+		void SetRefreshInterval(float fSeconds);
+
+	protected:
+		void OnAfterUserCreate() override;
+		void OnAfterUserUpdate(float fElapsedTime) override;
+
+	private:
+		void Redraw();
+
+	private:
+		static constexpr int nWidth = 256;
+		static constexpr int nHeight = 112;
+		static constexpr size_t nHistory = 240;
+
+		olc::Renderable panel;
+		// Puts the panel on layer 0 without touching the application's draw target
+		olc::DecalCommandBuffer cmdPanel;
+		olc::Key keyToggle;
+		olc::vf2d vPos = { -1.0f, -1.0f };
+		bool bShow = false;
+		bool bDrawnLastFrame = false;
+		bool bUploadedLastFrame = false;
+		float fRefresh = 0.1f;
+		float fSinceRefresh = 0.0f;
+
+		// Frame times in seconds, oldest first once full
+		std::vector<float> vFrameTimes;
+		size_t nNextFrame = 0;
+		olc::FrameStats stats;
+	};
+}
+
+#ifdef OLC_PGEX_PERFOVERLAY
+#undef OLC_PGEX_PERFOVERLAY
+
+namespace olc
+{
+	PerfOverlay::PerfOverlay(olc::Key toggleKey) : olc::PGEX(true), keyToggle(toggleKey)
+	{
+		vFrameTimes.reserve(nHistory);
+	}
+
+	void PerfOverlay::Show(bool b)
+	{
+		bShow = b;
+		// Draw straight away rather than waiting for the next refresh
+		fSinceRefresh = fRefresh;
+	}
+
+	bool PerfOverlay::IsShown() const
+	{ return bShow; }
+
+	void PerfOverlay::SetToggleKey(olc::Key key)
+	{ keyToggle = key; }
+
+	void PerfOverlay::SetPosition(const olc::vf2d& pos)
+	{ vPos = pos; }
+
+	void PerfOverlay::SetRefreshInterval(float fSeconds)
+	{ fRefresh = fSeconds; }
+
+	void PerfOverlay::OnAfterUserCreate()
+	{
+		panel.Create(nWidth, nHeight);
+	}
+
+	void PerfOverlay::OnAfterUserUpdate(float fElapsedTime)
+	{
+		if (pge->GetKey(keyToggle).bPressed) Show(!bShow);
+
+		// History is kept while hidden so the graph is full as soon as it is shown
+		stats = pge->GetFrameStats();
+		if (vFrameTimes.size() < nHistory) vFrameTimes.push_back(stats.fFrameTime);
+		else vFrameTimes[nNextFrame] = stats.fFrameTime;
+		nNextFrame = (nNextFrame + 1) % nHistory;
+
+		// Take out what the panel itself added to the frame being reported
+		if (bDrawnLastFrame && !stats.vLayerDecalInstances.empty() && stats.vLayerDecalInstances[0] > 0)
+		{
+			stats.vLayerDecalInstances[0]--;
+			stats.nDecalInstances--;
+		}
+		if (bUploadedLastFrame)
+			stats.nUploadBytes -= std::min<uint64_t>(stats.nUploadBytes, uint64_t(nWidth) * nHeight * sizeof(olc::Pixel));
+		bDrawnLastFrame = false;
+		bUploadedLastFrame = false;
+
+		if (!bShow || panel.Decal() == nullptr) return;
+
+		fSinceRefresh += fElapsedTime;
+		if (fSinceRefresh >= fRefresh)
+		{
+			fSinceRefresh = 0.0f;
+			Redraw();
+			panel.Decal()->Update();
+			bUploadedLastFrame = true;
+		}
+
+		olc::vf2d pos = vPos;
+		if (pos.x < 0.0f) pos = { float(pge->ScreenWidth() - nWidth - 4), 4.0f };
+
+		// Layer 0 is drawn last, so the panel sits over everything
+		cmdPanel.Begin(0);
+		pge->DrawDecal(pos, panel.Decal());
+		cmdPanel.End();
+		pge->SubmitDecalCommands(cmdPanel);
+		bDrawnLastFrame = true;
+	}
+
+	void PerfOverlay::Redraw()
+	{
+		olc::Sprite* pTarget = pge->GetDrawTarget();
+		olc::Pixel::Mode mode = pge->GetPixelMode();
+		pge->SetDrawTarget(panel.Sprite());
+		pge->SetPixelMode(olc::Pixel::NORMAL);
+		pge->Clear(olc::Pixel(0, 0, 0, 192));
+
+		// Percentiles over the frames in the history
+		std::vector<float> vSorted(vFrameTimes);
+		auto Percentile = [&](float f)
+		{
+			if (vSorted.empty()) return 0.0f;
+			size_t n = std::min(vSorted.size() - 1, size_t(f * float(vSorted.size())));
+			std::nth_element(vSorted.begin(), vSorted.begin() + n, vSorted.end());
+			return vSorted[n];
+		};
+		const float fP50 = Percentile(0.5f) * 1000.0f;
+		const float fP99 = Percentile(0.99f) * 1000.0f;
+
+		char buf[64];
+		int y = 2;
+		snprintf(buf, sizeof(buf), "%3u FPS  p50 %5.2f p99 %5.2f", pge->GetFPS(), fP50, fP99);
+		pge->DrawString(2, y, buf, olc::WHITE); y += 10;
+
+		snprintf(buf, sizeof(buf), "Decals %-5u Draws %u", stats.nDecalInstances, stats.nDrawCalls);
+		pge->DrawString(2, y, buf, olc::WHITE); y += 10;
+
+		// Only layers with something in them, as many as fit on the line
+		std::string sLayers;
+		for (size_t i = 0; i < stats.vLayerDrawCalls.size() && sLayers.size() < 24; i++)
+		{
+			if (stats.vLayerDrawCalls[i] == 0) continue;
+			snprintf(buf, sizeof(buf), "L%u %u/%u ", uint32_t(i), stats.vLayerDecalInstances[i], stats.vLayerDrawCalls[i]);
+			sLayers += buf;
+		}
+		pge->DrawString(2, y, sLayers, olc::GREY); y += 10;
+
+		if (stats.nUploadBytes >= 1024 * 1024)
+			snprintf(buf, sizeof(buf), "Upload %.2f MB", double(stats.nUploadBytes) / (1024.0 * 1024.0));
+		else
+			snprintf(buf, sizeof(buf), "Upload %.1f KB", double(stats.nUploadBytes) / 1024.0);
+		pge->DrawString(2, y, buf, olc::WHITE); y += 10;
+
+#if defined(OLC_TRACK_ALLOCATIONS)
+		snprintf(buf, sizeof(buf), "Allocs heap %-4u pixel %u", stats.nHeapAllocations, stats.nPixelAllocations);
+#else
+		snprintf(buf, sizeof(buf), "Allocs heap -    pixel %u", stats.nPixelAllocations);
+#endif
+		pge->DrawString(2, y, buf, olc::WHITE); y += 10;
+
+		// Frame time graph, newest on the right, scaled so 33ms fills it
+		const int nGraphTop = y + 2;
+		const int nGraphHeight = nHeight - nGraphTop - 2;
+		const float fScale = float(nGraphHeight) / 0.0333f;
+		const int nGraphLeft = nWidth - 2 - int(nHistory);
+		// 60Hz budget, behind the bars
+		const int y60 = nGraphTop + nGraphHeight - int(0.0167f * fScale + 0.5f);
+		pge->DrawLine(nGraphLeft, y60, nWidth - 3, y60, olc::DARK_GREY, 0xF0F0F0F0);
+		for (size_t i = 0; i < vFrameTimes.size(); i++)
+		{
+			// Oldest sample first
+			const float fTime = vFrameTimes[(nNextFrame + nHistory - vFrameTimes.size() + i) % nHistory];
+			const int nBar = std::min(nGraphHeight, int(fTime * fScale + 0.5f));
+			const olc::Pixel col = fTime > 0.0334f ? olc::RED : fTime > 0.0167f ? olc::YELLOW : olc::GREEN;
+			const int x = nGraphLeft + int(nHistory - vFrameTimes.size() + i);
+			if (nBar > 0) pge->DrawLine(x, nGraphTop + nGraphHeight - nBar, x, nGraphTop + nGraphHeight - 1, col);
+		}
+
+		pge->SetPixelMode(mode);
+		pge->SetDrawTarget(pTarget);
+	}
+}
+
+#endif
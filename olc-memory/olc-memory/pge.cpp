@@ -1,4 +1,15 @@
 #define OLC_PGE_APPLICATION
 #define OLC_PGEX_SPLASHSCREEN
+#define OLC_PGEX_ASSETMANAGER
+#define OLC_PGEX_PERFOVERLAY
+// Counting every heap allocation replaces the global operator new with one
+// that does an atomic add per call, delete only frees. Only debug builds pay
+// for it, define it for the whole build to opt in
+#if defined(_DEBUG) && !defined(OLC_TRACK_ALLOCATIONS)
+#define OLC_TRACK_ALLOCATIONS
+#endif
+#define OLC_IMAGE_CACHE
 #include "olcPixelGameEngine.h"
-#include "olc_PGEX_SplashScreen.h"
\ No newline at end of file
+#include "olc_PGEX_SplashScreen.h"
+#include "olc_PGEX_AssetManager.h"
+#include "olc_PGEX_PerfOverlay.h"
\ No newline at end of file
@@ -0,0 +1,169 @@
+/*
+	Checks how queued input turns into GetKey()/GetMouse() edges, wheel deltas
+	and GetInputEvents(): a click inside one frame, repeated presses, a release
+	with the wheel, a quiet frame, and recovery after the input ring overflows.
+	A second pass reports input from another thread while frames run, and is
+	meant to be run under ThreadSanitizer as well.
+
+	g++ -std=c++17 -O2 -I.. input_check.cpp -o input_check -lpthread
+	g++ -std=c++17 -O1 -g -fsanitize=thread -I.. input_check.cpp -o input_check_tsan -lpthread
+	./input_check
+*/
+
+#define OLC_PGE_HEADLESS
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+int nFailures = 0;
+
+void Expect(bool bPass, const char* sWhat, int nFrame)
+{
+	if (!bPass)
+	{
+		std::cout << "Failed in frame " << nFrame << ": " << sWhat << std::endl;
+		nFailures++;
+	}
+}
+
+// Input reported during one frame, checked in the next
+class InputSequence : public olc::PixelGameEngine
+{
+public:
+	int nFrame = 0;
+
+	bool OnUserCreate() override
+	{ return true; }
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		const olc::HWButton mouse = GetMouse(0);
+		const olc::HWButton key = GetKey(olc::Key::A);
+		const size_t nEvents = GetInputEvents().size();
+
+		if (nFrame > 0 && nFrame < 40)
+		{
+			switch ((nFrame - 1) % 4)
+			{
+			case 0:
+				Expect(mouse.bPressed && mouse.bReleased && !mouse.bHeld, "click within a frame shows both edges", nFrame);
+				Expect(nEvents == 3, "move, press and release are all listed", nFrame);
+				break;
+			case 1:
+				Expect(mouse.bPressed && !mouse.bReleased && mouse.bHeld && key.bPressed, "presses show once", nFrame);
+				Expect(nEvents == 2, "repeated press is not listed again", nFrame);
+				break;
+			case 2:
+				Expect(!mouse.bPressed && mouse.bReleased && !mouse.bHeld && key.bReleased, "releases show", nFrame);
+				Expect(GetMouseWheel() == -240, "wheel deltas add up", nFrame);
+				Expect(nEvents == 4, "releases and wheel are listed", nFrame);
+				break;
+			case 3:
+				Expect(!mouse.bPressed && !mouse.bReleased && !mouse.bHeld && !key.bPressed && !key.bReleased && !key.bHeld, "edges clear on a quiet frame", nFrame);
+				Expect(nEvents == 0 && GetMouseWheel() == 0, "quiet frame has no events", nFrame);
+				break;
+			}
+		}
+
+		if (nFrame < 40)
+		{
+			switch (nFrame % 4)
+			{
+			case 0: olc_UpdateMouse(5, 6); olc_UpdateMouseState(0, true); olc_UpdateMouseState(0, false); break;
+			case 1: olc_UpdateMouseState(0, true); olc_UpdateMouseState(0, true); olc_UpdateKeyState(olc::Key::A, true); break;
+			case 2: olc_UpdateMouseState(0, false); olc_UpdateKeyState(olc::Key::A, false); olc_UpdateMouseWheel(-120); olc_UpdateMouseWheel(-120); break;
+			default: break;
+			}
+		}
+
+		switch (nFrame)
+		{
+		case 40:
+			// Far more than the ring holds, ending held
+			for (int i = 0; i < 5000; i++) { olc_UpdateKeyState(olc::Key::B, true); olc_UpdateKeyState(olc::Key::B, false); }
+			olc_UpdateKeyState(olc::Key::B, true);
+			break;
+		case 41:
+			Expect(GetKey(olc::Key::B).bHeld, "state after overflow matches the platform", nFrame);
+			break;
+		case 42:
+			Expect(!GetKey(olc::Key::B).bPressed && GetKey(olc::Key::B).bHeld, "no repeated edge after overflow", nFrame);
+			olc_UpdateKeyState(olc::Key::B, false);
+			break;
+		case 43:
+			Expect(GetKey(olc::Key::B).bReleased && !GetKey(olc::Key::B).bHeld, "input after overflow is delivered", nFrame);
+			break;
+		}
+
+		return ++nFrame < 44;
+	}
+};
+
+// Input reported on another thread, as platforms with their own event thread do
+class InputStream : public olc::PixelGameEngine
+{
+public:
+	std::atomic<bool> bRunning{ false };
+	std::atomic<bool> bStop{ false };
+	int nDowns = 0, nUps = 0, nWheel = 0, nFrames = 0;
+	uint64_t nLastTime = 0;
+	bool bOrdered = true;
+
+	bool OnUserCreate() override
+	{ return true; }
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		bRunning = true;
+		for (const auto& e : GetInputEvents())
+		{
+			bOrdered &= e.nTime >= nLastTime;
+			nLastTime = e.nTime;
+			if (e.type == olc::InputEvent::Type::MOUSE_DOWN) nDowns++;
+			if (e.type == olc::InputEvent::Type::MOUSE_UP) nUps++;
+		}
+		nWheel += GetMouseWheel();
+		nFrames++;
+		// The odd long frame, so the ring sometimes overflows
+		if (nFrames % 50 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return !(bStop && GetInputEvents().empty());
+	}
+};
+
+int main()
+{
+	InputSequence sequence;
+	if (sequence.Construct(100, 100, 1, 1))
+		sequence.Start();
+
+	InputStream stream;
+	if (stream.Construct(100, 100, 1, 1))
+	{
+		std::thread platform([&]()
+		{
+			while (!stream.bRunning) std::this_thread::yield();
+			for (int i = 0; i < 20000; i++)
+			{
+				stream.olc_UpdateMouse(i % 100, i % 77);
+				stream.olc_UpdateMouseState(0, true);
+				stream.olc_UpdateMouseState(0, false);
+				stream.olc_UpdateMouseWheel(1);
+				if (i % 100 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			stream.bStop = true;
+		});
+		stream.Start();
+		platform.join();
+
+		// Dropped clicks are not stood in for, only the state they left behind, so presses
+		// and releases need not pair up
+		Expect(stream.nDowns > 0 && stream.nUps > 0, "presses and releases are delivered", stream.nFrames);
+		Expect(stream.GetMousePos() == olc::vi2d(19999 % 100, 19999 % 77), "position is the last reported", stream.nFrames);
+		Expect(stream.nWheel > 0 && stream.nWheel <= 20000, "wheel is not over counted", stream.nFrames);
+		Expect(!stream.GetMouse(0).bHeld, "button ends released", stream.nFrames);
+		Expect(stream.bOrdered, "events arrive in time order", stream.nFrames);
+	}
+
+	std::cout << (nFailures == 0 ? "Input checks passed" : "Input checks failed") << std::endl;
+	return nFailures == 0 ? 0 : 1;
+}
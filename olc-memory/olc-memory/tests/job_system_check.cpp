@@ -0,0 +1,87 @@
+/*
+	Exercises olc::JobSystem: ParallelFor() covering a range exactly, nested
+	ParallelFor() inside its own ranges, diamond shaped dependency graphs, long
+	dependency chains, and Stop() draining jobs nobody waited on. Meant to be
+	run under ThreadSanitizer as well as on its own.
+
+	g++ -std=c++17 -O2 -I.. job_system_check.cpp -o job_system_check -lpthread
+	g++ -std=c++17 -O1 -g -fsanitize=thread -I.. job_system_check.cpp -o job_system_check_tsan -lpthread
+	./job_system_check
+*/
+
+#define OLC_PGE_HEADLESS
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+int nFailures = 0;
+
+void Expect(bool bPass, const char* sWhat)
+{
+	if (!bPass)
+	{
+		std::cout << "Failed: " << sWhat << std::endl;
+		nFailures++;
+	}
+}
+
+int main()
+{
+	for (int nRound = 0; nRound < 3; nRound++)
+	{
+		olc::JobSystem jobs;
+		jobs.Start(3);
+
+		// Every index written once, by whichever thread claimed its range
+		std::vector<uint32_t> vIndices(100000, 0);
+		jobs.ParallelFor(0, uint32_t(vIndices.size()), 1000, [&](uint32_t nFirst, uint32_t nLast)
+		{
+			for (uint32_t i = nFirst; i < nLast; i++) vIndices[i] += i + 1;
+		});
+		bool bCovered = true;
+		for (uint32_t i = 0; i < vIndices.size(); i++) bCovered &= vIndices[i] == i + 1;
+		Expect(bCovered, "ParallelFor covers each index exactly once");
+
+		// Waiting inside a range helps with other ranges rather than blocking a worker
+		std::atomic<uint32_t> nNested{ 0 };
+		jobs.ParallelFor(0, 64, 1, [&](uint32_t nFirst, uint32_t nLast)
+		{
+			for (uint32_t i = nFirst; i < nLast; i++)
+				jobs.ParallelFor(0, 100, 7, [&](uint32_t a, uint32_t b) { nNested += b - a; });
+		});
+		Expect(nNested == 6400, "nested ParallelFor covers every inner range");
+
+		// a before b and c, both before d, whatever order b and c take
+		for (int n = 0; n < 200; n++)
+		{
+			std::atomic<int> nStep{ 0 };
+			int nA = -1, nB = -1, nC = -1, nD = -1;
+			olc::JobHandle a = jobs.Schedule([&] { nA = nStep++; });
+			olc::JobHandle b = jobs.Schedule([&] { nB = nStep++; }, { a });
+			olc::JobHandle c = jobs.Schedule([&] { nC = nStep++; }, { a });
+			olc::JobHandle d = jobs.Schedule([&] { nD = nStep++; }, { b, c, nullptr });
+			jobs.Wait(d);
+			if (nA != 0 || nB < 1 || nC < 1 || nD != 3)
+			{
+				Expect(false, "diamond runs in dependency order");
+				break;
+			}
+		}
+
+		// A tree of jobs, each depending on one scheduled earlier, some already finished
+		std::atomic<int> nTree{ 0 };
+		std::vector<olc::JobHandle> vTree;
+		for (int i = 0; i < 5000; i++)
+			vTree.push_back(jobs.Schedule([&] { nTree++; }, { i ? vTree[i / 2] : nullptr }));
+		for (auto& job : vTree) jobs.Wait(job);
+		Expect(nTree == 5000, "every job in the tree ran");
+
+		// Jobs nobody waits on still run before Stop() returns
+		std::atomic<int> nDrained{ 0 };
+		for (int i = 0; i < 1000; i++) jobs.Schedule([&] { nDrained++; });
+		jobs.Stop();
+		Expect(nDrained == 1000, "Stop drains queued jobs");
+	}
+
+	std::cout << (nFailures == 0 ? "JobSystem checks passed" : "JobSystem checks failed") << std::endl;
+	return nFailures == 0 ? 0 : 1;
+}
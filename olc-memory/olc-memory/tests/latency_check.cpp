@@ -0,0 +1,77 @@
+/*
+	Checks that LatencyTracker measures an injected input through to the frame
+	that marked it, and that Clear() drops responses not yet displayed.
+
+	g++ -std=c++17 -O2 -I.. latency_check.cpp -o latency_check -lpthread
+	./latency_check
+*/
+
+#define OLC_PGE_HEADLESS
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+class LatencyCheck : public olc::PixelGameEngine
+{
+public:
+	int nFrame = 0;
+	int nFailures = 0;
+
+	void Expect(bool bPass, const char* sWhat)
+	{
+		if (!bPass)
+		{
+			std::cout << "Failed: " << sWhat << std::endl;
+			nFailures++;
+		}
+	}
+
+	bool OnUserCreate() override
+	{
+		olc::LatencyTracker::Clear();
+		olc::LatencyTracker::Enable(true);
+		return true;
+	}
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		for (const auto& e : GetInputEvents())
+			if (e.type == olc::InputEvent::Type::MOUSE_DOWN)
+				olc::LatencyTracker::MarkResponse(e.nTime, "Check");
+
+		switch (nFrame++)
+		{
+		case 0:
+			// Seen by the next update, measured when that frame is submitted
+			olc_UpdateMouseState(0, true);
+			break;
+
+		case 2:
+			Expect(olc::LatencyTracker::GetPercentile("Check", 0.5f) > 0.0f, "marked response was measured");
+			Expect(olc::LatencyTracker::GetPercentile("Input", 0.5f) > 0.0f, "button press was measured");
+			olc_UpdateMouseState(0, false);
+			olc_UpdateMouseState(0, true);
+			break;
+
+		case 3:
+			// The press was marked above, clearing now must drop it with the samples
+			olc::LatencyTracker::Clear();
+			break;
+
+		case 5:
+			Expect(olc::LatencyTracker::GetPercentile("Check", 0.5f) == 0.0f, "cleared response was not measured");
+			Expect(olc::LatencyTracker::GetPercentile("Input", 0.5f) == 0.0f, "cleared press was not measured");
+			return false;
+		}
+		return true;
+	}
+};
+
+int main()
+{
+	LatencyCheck pge;
+	if (pge.Construct(64, 64, 1, 1))
+		pge.Start();
+
+	std::cout << (pge.nFailures == 0 ? "LatencyTracker measures marked input" : "LatencyTracker check failed") << std::endl;
+	return pge.nFailures == 0 ? 0 : 1;
+}
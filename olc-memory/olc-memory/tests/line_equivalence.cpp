@@ -0,0 +1,134 @@
+/*
+	Checks that DrawLine() plots exactly the pixels the original per pixel
+	Bresenham did, for random lines across and far beyond the draw target,
+	with random patterns, in every pixel mode.
+
+	g++ -std=c++17 -O2 -I.. line_equivalence.cpp -o line_equivalence -lpthread
+	./line_equivalence
+*/
+
+#define OLC_PGE_HEADLESS
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+#include <random>
+
+class LineTest : public olc::PixelGameEngine
+{
+public:
+	// DrawLine() as it was before lines were clipped, every pixel goes through Draw()
+	void ReferenceLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc::Pixel p, uint32_t pattern)
+	{
+		int x, y, dx, dy, dx1, dy1, px, py, xe, ye, i;
+		dx = x2 - x1; dy = y2 - y1;
+
+		auto rol = [&](void) { pattern = (pattern << 1) | (pattern >> 31); return pattern & 1; };
+
+		if (dx == 0)
+		{
+			if (y2 < y1) std::swap(y1, y2);
+			for (y = y1; y <= y2; y++) if (rol()) Draw(x1, y, p);
+			return;
+		}
+
+		if (dy == 0)
+		{
+			if (x2 < x1) std::swap(x1, x2);
+			for (x = x1; x <= x2; x++) if (rol()) Draw(x, y1, p);
+			return;
+		}
+
+		dx1 = abs(dx); dy1 = abs(dy);
+		px = 2 * dy1 - dx1;	py = 2 * dx1 - dy1;
+		if (dy1 <= dx1)
+		{
+			if (dx >= 0) { x = x1; y = y1; xe = x2; }
+			else { x = x2; y = y2; xe = x1; }
+
+			if (rol()) Draw(x, y, p);
+
+			for (i = 0; x < xe; i++)
+			{
+				x = x + 1;
+				if (px < 0)
+					px = px + 2 * dy1;
+				else
+				{
+					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) y = y + 1; else y = y - 1;
+					px = px + 2 * (dy1 - dx1);
+				}
+				if (rol()) Draw(x, y, p);
+			}
+		}
+		else
+		{
+			if (dy >= 0) { x = x1; y = y1; ye = y2; }
+			else { x = x2; y = y2; ye = y1; }
+
+			if (rol()) Draw(x, y, p);
+
+			for (i = 0; y < ye; i++)
+			{
+				y = y + 1;
+				if (py <= 0)
+					py = py + 2 * dx1;
+				else
+				{
+					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) x = x + 1; else x = x - 1;
+					py = py + 2 * (dx1 - dy1);
+				}
+				if (rol()) Draw(x, y, p);
+			}
+		}
+	}
+};
+
+int main()
+{
+	LineTest pge;
+	olc::Sprite sprNew(160, 120), sprRef(160, 120);
+	std::mt19937 rng(1234);
+	auto range = [&](int32_t lo, int32_t hi) { return lo + int32_t(rng() % uint32_t(hi - lo + 1)); };
+
+	const olc::Pixel::Mode modes[] = { olc::Pixel::NORMAL, olc::Pixel::MASK, olc::Pixel::ALPHA, olc::Pixel::CUSTOM };
+	int nFailures = 0;
+	for (int nScene = 0; nScene < 4000; nScene++)
+	{
+		const olc::Pixel::Mode mode = modes[nScene % 4];
+		if (mode == olc::Pixel::CUSTOM)
+			pge.SetPixelMode([](const int x, const int y, const olc::Pixel& s, const olc::Pixel& d) { return olc::Pixel(s.r ^ d.g, uint8_t(x), uint8_t(y)); });
+		else
+			pge.SetPixelMode(mode);
+		pge.SetPixelBlend(float(rng() % 101) / 100.0f);
+
+		for (auto& p : sprNew.pColData) p.n = rng();
+		sprRef.pColData = sprNew.pColData;
+
+		// Mostly near the target, some from thousands of pixels away, and some
+		// straight lines, which take their own paths
+		const int32_t nReach = (nScene % 3 == 0) ? 20000 : 300;
+		for (int n = 0; n < 16; n++)
+		{
+			int32_t x1 = range(-nReach, nReach), y1 = range(-nReach, nReach);
+			int32_t x2 = range(-nReach, nReach), y2 = range(-nReach, nReach);
+			if (rng() % 5 == 0) y2 = y1; else if (rng() % 5 == 0) x2 = x1;
+			const uint32_t nPattern = (rng() % 2) ? 0xFFFFFFFF : uint32_t(rng());
+			const olc::Pixel col(rng(), rng(), rng(), (rng() % 2) ? 255 : rng() % 256);
+
+			pge.SetDrawTarget(&sprNew);
+			pge.DrawLine(x1, y1, x2, y2, col, nPattern);
+			pge.SetDrawTarget(&sprRef);
+			pge.ReferenceLine(x1, y1, x2, y2, col, nPattern);
+
+			if (sprNew.pColData != sprRef.pColData)
+			{
+				if (nFailures++ < 10)
+					std::cout << "Mismatch in scene " << nScene << ": (" << x1 << "," << y1 << ") - (" << x2 << "," << y2 << ") pattern " << std::hex << nPattern << std::dec << std::endl;
+				sprRef.pColData = sprNew.pColData;
+			}
+		}
+	}
+
+	std::cout << (nFailures == 0 ? "DrawLine matches the reference" : "DrawLine differs from the reference") << std::endl;
+	return nFailures == 0 ? 0 : 1;
+}